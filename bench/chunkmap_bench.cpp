@@ -0,0 +1,74 @@
+// Compares chunk lookup cost of both ChunkMap storage modes against the std::map storage they replaced.
+#include "world/chunkmap.h"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int LOADED_RADIUS = 11; // Matches World::UNLOAD_DISTANCE
+const int LOOKUPS = 4'000'000;
+
+template <typename Lookup>
+double nanosecondsPerLookup(const std::vector<ChunkCoord>& queries, Lookup lookup) {
+    unsigned long long found = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < LOOKUPS; ++i) {
+        found += lookup(queries[i % queries.size()]) ? 1 : 0;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    // Keep the loop from being optimised away
+    if (found == 0) std::printf(" ");
+    return std::chrono::duration<double, std::nano>(end - start).count() / LOOKUPS;
+}
+
+} // namespace
+
+int main() {
+    ChunkMap chunkMap;
+    ChunkMap chunkRing(ChunkStorageMode::RingBuffer, 2 * LOADED_RADIUS + 1);
+    std::map<ChunkCoord, Chunk*, ivec2_compare> treeMap;
+
+    for (int x = -LOADED_RADIUS; x <= LOADED_RADIUS; ++x) {
+        for (int z = -LOADED_RADIUS; z <= LOADED_RADIUS; ++z) {
+            Chunk& chunk = chunkMap.insert(ChunkCoord(x, z), PooledChunk(new Chunk()));
+            treeMap.emplace(ChunkCoord(x, z), &chunk);
+            chunkRing.emplace(ChunkCoord(x, z));
+        }
+    }
+
+    // Random lookups across the loaded area, plus some misses just outside it
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<int> coord(-LOADED_RADIUS - 2, LOADED_RADIUS + 2);
+    std::vector<ChunkCoord> randomQueries(1 << 16);
+    for (ChunkCoord& query : randomQueries) {
+        query = ChunkCoord(coord(rng), coord(rng));
+    }
+
+    // Coherent lookups, as physics and raycasts walk neighbouring blocks of the same chunk
+    std::vector<ChunkCoord> coherentQueries;
+    for (int x = -LOADED_RADIUS; x <= LOADED_RADIUS; ++x) {
+        for (int z = -LOADED_RADIUS; z <= LOADED_RADIUS; ++z) {
+            for (int repeat = 0; repeat < 16; ++repeat) {
+                coherentQueries.push_back(ChunkCoord(x, z));
+            }
+        }
+    }
+
+    auto chunkMapLookup = [&](const ChunkCoord& c) { return chunkMap.find(c) != nullptr; };
+    auto chunkRingLookup = [&](const ChunkCoord& c) { return chunkRing.find(c) != nullptr; };
+    auto treeMapLookup = [&](const ChunkCoord& c) { return treeMap.find(c) != treeMap.end(); };
+
+    std::printf("%zu chunks loaded, %d lookups per run\n", chunkMap.size(), LOOKUPS);
+    std::printf("random:   std::map %.2f ns, ChunkMap %.2f ns, ring buffer %.2f ns\n",
+                nanosecondsPerLookup(randomQueries, treeMapLookup), nanosecondsPerLookup(randomQueries, chunkMapLookup),
+                nanosecondsPerLookup(randomQueries, chunkRingLookup));
+    std::printf("coherent: std::map %.2f ns, ChunkMap %.2f ns, ring buffer %.2f ns\n",
+                nanosecondsPerLookup(coherentQueries, treeMapLookup), nanosecondsPerLookup(coherentQueries, chunkMapLookup),
+                nanosecondsPerLookup(coherentQueries, chunkRingLookup));
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+// Times the CPU hot paths of the world pipeline and prints the results as JSON, so runs can be compared between releases.
+// Usage: world-bench [output.json]
+#include "world/world.h"
+#include "world/chunksystem.h"
+#include "world/raycast.h"
+#include "ecs/components.h"
+#include "ecs/registry.h"
+#include "physics/physicssystem.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int WORLD_SEED = 1337;
+const unsigned RNG_SEED = 42;
+const int LOADED_RADIUS = 4; // Chunks created around the origin for lookups, raycasts and physics
+const int ENTITY_COUNT = 4096;
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double nanosecondsPerOp;
+};
+
+// Same terrain settings as main.cpp, with a fixed seed
+void configureNoise(FastNoiseLite& noise, FastNoiseLite& detailNoise) {
+    noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    noise.SetFrequency(0.003f);
+    noise.SetSeed(WORLD_SEED);
+    noise.SetFractalType(noise.FractalType_Ridged);
+    noise.SetFractalLacunarity(1.0f);
+    noise.SetFractalOctaves(4);
+    noise.SetFractalGain(2.0f);
+    noise.SetFractalWeightedStrength(3.0f);
+
+    detailNoise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+    detailNoise.SetFrequency(0.07f);
+    detailNoise.SetSeed(WORLD_SEED);
+}
+
+// Runs `op(i)` for every i in [0, iterations) and records the mean time per call
+template <typename Op>
+void measure(std::vector<BenchResult>& results, const char* name, long long iterations, Op op) {
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; ++i) {
+        op(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double total = std::chrono::duration<double, std::nano>(end - start).count();
+    results.push_back({name, iterations, total / iterations});
+}
+
+int surfaceHeight(const World& world, int x, int z) {
+    for (int y = CHUNK_HEIGHT - 1; y >= 0; --y) {
+        if (world.getBlock(x, y, z) != BlockID::Air) return y + 1;
+    }
+    return 0;
+}
+
+void writeJson(std::FILE* out, const std::vector<BenchResult>& results) {
+    std::fprintf(out, "{\n  \"world_seed\": %d,\n  \"rng_seed\": %u,\n  \"benchmarks\": [\n", WORLD_SEED, RNG_SEED);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        std::fprintf(out, "    {\"name\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.2f, \"ops_per_second\": %.0f}%s\n",
+                     result.name.c_str(), result.iterations, result.nanosecondsPerOp, 1e9 / result.nanosecondsPerOp,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    FastNoiseLite noise, detailNoise;
+    configureNoise(noise, detailNoise);
+
+    std::vector<BenchResult> results;
+    std::mt19937 rng(RNG_SEED);
+    unsigned long long sink = 0; // Keeps results observable so loops are not optimised away
+
+    // Chunk generation, cycling through different columns so the noise input varies
+    Chunk scratch;
+    measure(results, "chunk_generate", 64, [&](long long i) {
+        ChunkSystem::generate(scratch, (int)(i % 8) - 4, (int)(i / 8) - 4, noise, detailNoise);
+        sink += (unsigned long long)scratch.getBlock(0, 64, 0);
+    });
+
+    // Meshing a chunk surrounded by its four neighbours
+    Chunk centre, posX, negX, posZ, negZ;
+    ChunkSystem::generate(centre, 0, 0, noise, detailNoise);
+    ChunkSystem::generate(posX, 1, 0, noise, detailNoise);
+    ChunkSystem::generate(negX, -1, 0, noise, detailNoise);
+    ChunkSystem::generate(posZ, 0, 1, noise, detailNoise);
+    ChunkSystem::generate(negZ, 0, -1, noise, detailNoise);
+    measure(results, "chunk_mesh_greedy", 64, [&](long long) {
+        sink += ChunkSystem::buildMeshData(centre, &posX, &negX, &posZ, &negZ, MeshingMode::Greedy).size();
+    });
+    measure(results, "chunk_mesh_naive", 64, [&](long long) {
+        sink += ChunkSystem::buildMeshData(centre, &posX, &negX, &posZ, &negZ, MeshingMode::Naive).size();
+    });
+    // Remeshing after a block edit, which rebuilds a single section near the surface
+    measure(results, "chunk_mesh_section", 256, [&](long long) {
+        sink += ChunkSystem::buildSectionMeshData(centre, &posX, &negX, &posZ, &negZ, 1u << 4)[4].size();
+    });
+
+    // The rest runs against a small loaded world; one worker since nothing is streamed
+    World world(noise, detailNoise, 1);
+    for (int x = -LOADED_RADIUS; x <= LOADED_RADIUS; ++x) {
+        for (int z = -LOADED_RADIUS; z <= LOADED_RADIUS; ++z) {
+            world.createChunk(x, z);
+        }
+    }
+    const int minBlock = -LOADED_RADIUS * CHUNK_WIDTH;
+    const int maxBlock = (LOADED_RADIUS + 1) * CHUNK_WIDTH - 1;
+
+    std::uniform_int_distribution<int> blockCoord(minBlock, maxBlock);
+    std::uniform_int_distribution<int> blockHeight(0, CHUNK_HEIGHT - 1);
+    std::vector<glm::ivec3> randomBlocks(1 << 16);
+    for (glm::ivec3& block : randomBlocks) {
+        block = glm::ivec3(blockCoord(rng), blockHeight(rng), blockCoord(rng));
+    }
+    measure(results, "world_get_block_random", 4'000'000, [&](long long i) {
+        const glm::ivec3& block = randomBlocks[i & (randomBlocks.size() - 1)];
+        sink += (unsigned long long)world.getBlock(block.x, block.y, block.z);
+    });
+
+    // Coherent access walks a 16x16x16 box block by block, as physics and meshing do
+    measure(results, "world_get_block_coherent", 4'000'000, [&](long long i) {
+        int x = (int)(i & 15), z = (int)((i >> 4) & 15), y = 56 + (int)((i >> 8) & 15);
+        sink += (unsigned long long)world.getBlock(x, y, z);
+    });
+
+    // Raycasts from eye height on the surface, with the reach used for block picking
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<glm::vec3> rayOrigins(4096), rayDirections(4096);
+    for (size_t i = 0; i < rayOrigins.size(); ++i) {
+        int x = blockCoord(rng), z = blockCoord(rng);
+        rayOrigins[i] = glm::vec3(x + 0.5f, surfaceHeight(world, x, z) + 1.6f, z + 0.5f);
+        rayDirections[i] = glm::vec3(unit(rng), unit(rng) - 0.3f, unit(rng));
+    }
+    measure(results, "raycast_reach_5", 200'000, [&](long long i) {
+        size_t ray = i & (rayOrigins.size() - 1);
+        sink += RaycastSystem::cast(world, rayOrigins[ray], rayDirections[ray], 5.0f).has_value();
+    });
+    measure(results, "raycast_reach_64", 50'000, [&](long long i) {
+        size_t ray = i & (rayOrigins.size() - 1);
+        sink += RaycastSystem::cast(world, rayOrigins[ray], rayDirections[ray], 64.0f).has_value();
+    });
+
+    // Batches of light-probe style rays from all over the loaded area, each reported per ray
+    std::vector<Ray> batchRays(16384);
+    for (Ray& ray : batchRays) {
+        int x = blockCoord(rng), z = blockCoord(rng);
+        ray = {glm::vec3(x + 0.5f, surfaceHeight(world, x, z) + 1.6f, z + 0.5f), glm::vec3(unit(rng), unit(rng), unit(rng)), 64.0f};
+    }
+    std::vector<std::optional<RaycastResult>> batchResults(batchRays.size());
+    ThreadPool rayWorkers;
+    measure(results, "raycast_batch_64_single_thread", (long long)batchRays.size() * 8, [&](long long i) {
+        if (i % batchRays.size() == 0) RaycastSystem::castBatch(world, batchRays, batchResults);
+    });
+    measure(results, "raycast_batch_64_threaded", (long long)batchRays.size() * 8, [&](long long i) {
+        if (i % batchRays.size() == 0) RaycastSystem::castBatch(world, batchRays, batchResults, &rayWorkers);
+    });
+    sink += batchResults[0].has_value();
+
+    // A player-sized box walking across the terrain at 60 steps per second
+    glm::vec3 position(0.5f, surfaceHeight(world, 0, 0) + 2.0f, 0.5f);
+    glm::vec3 velocity(0.0f);
+    AABB boundingBox(position, glm::vec3(0.8f, 3.3f, 0.8f));
+    bool onGround = false;
+    const float deltaTime = 1.0f / 60.0f;
+    measure(results, "physics_resolve_collision", 1'000'000, [&](long long i) {
+        // Turn every few seconds and jump when landed, staying inside the loaded area
+        float heading = (float)(i / 240) * 2.4f;
+        velocity.x = std::cos(heading) * 4.3f;
+        velocity.z = std::sin(heading) * 4.3f;
+        if (onGround) velocity.y = 10.0f;
+        velocity.y -= World::GRAVITY * deltaTime;
+        if (position.x < minBlock + 8 || position.x > maxBlock - 8 || position.z < minBlock + 8 || position.z > maxBlock - 8) {
+            position = glm::vec3(0.5f, surfaceHeight(world, 0, 0) + 2.0f, 0.5f);
+            velocity = glm::vec3(0.0f);
+        }
+        PhysicsSystem::resolveCollision(world, boundingBox, position, velocity, onGround, deltaTime);
+        sink += onGround;
+    });
+
+    // Thousands of player-sized entities dropped on the terrain and walking, stepped through the registry.
+    // Timed per entity; a second of simulation keeps them all well inside the loaded area
+    Registry registry;
+    std::uniform_real_distribution<float> heading(0.0f, 6.2832f);
+    std::uniform_int_distribution<int> spawnCoord(minBlock + 16, maxBlock - 16);
+    for (int i = 0; i < ENTITY_COUNT; ++i) {
+        Entity entity = registry.create();
+        int x = spawnCoord(rng), z = spawnCoord(rng);
+        float angle = heading(rng);
+        glm::vec3 spawn(x + 0.5f, surfaceHeight(world, x, z) + 2.0f, z + 0.5f);
+        registry.emplace<Transform>(entity, spawn);
+        registry.emplace<Velocity>(entity, glm::vec3(std::cos(angle) * 4.3f, 0.0f, std::sin(angle) * 4.3f));
+        registry.emplace<Collider>(entity, AABB(spawn, glm::vec3(0.8f, 1.8f, 0.8f)));
+    }
+    measure(results, "physics_update_entities", (long long)ENTITY_COUNT * 60, [&](long long i) {
+        if (i % ENTITY_COUNT == 0) PhysicsSystem::update(registry, world, deltaTime);
+    });
+    registry.view<Collider>().each([&](Entity, Collider& collider) { sink += collider.onGround; });
+
+    std::FILE* out = stdout;
+    if (argc > 1) {
+        out = std::fopen(argv[1], "w");
+        if (!out) {
+            std::fprintf(stderr, "Could not open %s for writing\n", argv[1]);
+            return 1;
+        }
+    }
+    writeJson(out, results);
+    if (out != stdout) std::fclose(out);
+
+    // Never true in practice, but the compiler cannot know that
+    if (sink == 0) std::fprintf(stderr, "no work done\n");
+    return 0;
+}
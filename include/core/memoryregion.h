@@ -0,0 +1,32 @@
+#ifndef MEMORYREGION_H
+#define MEMORYREGION_H
+
+#include <cstddef>
+
+// One block of memory for a pool to carve up, optionally advised onto transparent huge pages on Linux.
+// The size is rounded up to the alignment, which is the huge page size when huge pages are asked for.
+class MemoryRegion {
+public:
+    MemoryRegion(size_t bytes, bool hugePages);
+    ~MemoryRegion();
+
+    MemoryRegion(const MemoryRegion&) = delete;
+    MemoryRegion& operator=(const MemoryRegion&) = delete;
+
+    void* data() const { return m_Data; }
+    size_t size() const { return m_Size; }
+    // The kernel accepted the huge page advice; without THP enabled for madvise the region uses normal pages
+    bool hugePages() const { return m_HugePages; }
+
+    bool contains(const void* pointer) const {
+        const char* address = static_cast<const char*>(pointer);
+        return address >= static_cast<const char*>(m_Data) && address < static_cast<const char*>(m_Data) + m_Size;
+    }
+
+private:
+    void* m_Data = nullptr;
+    size_t m_Size = 0;
+    bool m_HugePages = false;
+};
+
+#endif
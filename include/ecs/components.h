@@ -0,0 +1,25 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <glm/glm.hpp>
+#include "physics/aabb.h"
+
+// Components shared by the engine's systems. Data only; the systems own the behaviour
+
+// World position of the entity's centre
+struct Transform {
+    glm::vec3 position = glm::vec3(0.0f);
+};
+
+// Blocks per second
+struct Velocity {
+    glm::vec3 linear = glm::vec3(0.0f);
+};
+
+// Box collided against the terrain. Only its size is read; the physics system recentres it on the Transform
+struct Collider {
+    AABB box;
+    bool onGround = false;
+};
+
+#endif
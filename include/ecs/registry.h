@@ -0,0 +1,240 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Handle to an entity: the low bits index the registry's slots and the high bits count how often the slot was
+// reused, so a handle kept past destroy() never matches the entity that takes its slot
+using Entity = uint32_t;
+
+constexpr int ENTITY_INDEX_BITS = 20;
+constexpr Entity ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr Entity NULL_ENTITY = 0xFFFFFFFF;
+
+inline uint32_t entityIndex(Entity entity) {
+    return entity & ENTITY_INDEX_MASK;
+}
+
+inline uint32_t entityVersion(Entity entity) {
+    return entity >> ENTITY_INDEX_BITS;
+}
+
+// Sparse set of the entities that have one component type. The entities are packed in a dense array, and the sparse
+// array maps an entity index to its position there, so membership is a single lookup and iteration never skips holes
+class ComponentPoolBase {
+public:
+    virtual ~ComponentPoolBase() = default;
+
+    bool contains(Entity entity) const {
+        uint32_t index = entityIndex(entity);
+        return index < m_Sparse.size() && m_Sparse[index] != ABSENT && m_Dense[m_Sparse[index]] == entity;
+    }
+
+    size_t size() const { return m_Dense.size(); }
+    // Entities in the same order as their components
+    const std::vector<Entity>& entities() const { return m_Dense; }
+
+    // Does nothing when the entity has no such component
+    virtual void remove(Entity entity) = 0;
+
+protected:
+    static constexpr uint32_t ABSENT = 0xFFFFFFFF;
+
+    std::vector<uint32_t> m_Sparse; // Dense position per entity index, or ABSENT
+    std::vector<Entity> m_Dense;
+};
+
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    // Replaces the component when the entity already has one. The registry checks the entity is alive
+    template <typename... Args>
+    T& emplace(Entity entity, Args&&... args) {
+        if (contains(entity)) {
+            T& component = m_Components[m_Sparse[entityIndex(entity)]];
+            component = make(std::forward<Args>(args)...);
+            return component;
+        }
+
+        uint32_t index = entityIndex(entity);
+        if (index >= m_Sparse.size()) {
+            m_Sparse.resize(index + 1, ABSENT);
+        }
+        m_Sparse[index] = (uint32_t)m_Dense.size();
+        m_Dense.push_back(entity);
+        m_Components.push_back(make(std::forward<Args>(args)...));
+        return m_Components.back();
+    }
+
+    // Moves the last component into the hole, so the arrays stay packed
+    void remove(Entity entity) override {
+        if (!contains(entity)) return;
+
+        uint32_t position = m_Sparse[entityIndex(entity)];
+        if (position + 1 < m_Dense.size()) {
+            Entity last = m_Dense.back();
+            m_Dense[position] = last;
+            m_Components[position] = std::move(m_Components.back());
+            m_Sparse[entityIndex(last)] = position;
+        }
+
+        m_Dense.pop_back();
+        m_Components.pop_back();
+        m_Sparse[entityIndex(entity)] = ABSENT;
+    }
+
+    // The entity must have the component
+    T& get(Entity entity) { return m_Components[m_Sparse[entityIndex(entity)]]; }
+    const T& get(Entity entity) const { return m_Components[m_Sparse[entityIndex(entity)]]; }
+
+    T* tryGet(Entity entity) { return contains(entity) ? &get(entity) : nullptr; }
+    const T* tryGet(Entity entity) const { return contains(entity) ? &get(entity) : nullptr; }
+
+private:
+    template <typename... Args>
+    static T make(Args&&... args) {
+        if constexpr (std::is_aggregate_v<T>) {
+            return T{std::forward<Args>(args)...};
+        } else {
+            return T(std::forward<Args>(args)...);
+        }
+    }
+
+    std::vector<T> m_Components;
+};
+
+// Entities that have every one of `Ts`. Iteration walks the smallest pool and looks the entity up in the others
+template <typename... Ts>
+class View {
+public:
+    // Any pool may be null when no entity ever had that component, which makes the view empty
+    explicit View(ComponentPool<Ts>*... pools) : m_Pools(pools...) {}
+
+    // Calls `func(entity, components...)` for each entity in the view. Components of the viewed types must not be
+    // added or removed during the call, except removing them from the entity being visited
+    template <typename Func>
+    void each(Func func) const {
+        const ComponentPoolBase* lead = smallestPool();
+        if (!lead) return;
+
+        const std::vector<Entity>& entities = lead->entities();
+        // Backwards, so removing the visited entity only moves one that was already visited into its place
+        for (size_t i = entities.size(); i-- > 0;) {
+            Entity entity = entities[i];
+            if ((std::get<ComponentPool<Ts>*>(m_Pools)->contains(entity) && ...)) {
+                func(entity, std::get<ComponentPool<Ts>*>(m_Pools)->get(entity)...);
+            }
+        }
+    }
+
+private:
+    const ComponentPoolBase* smallestPool() const {
+        const ComponentPoolBase* smallest = nullptr;
+        bool missing = false;
+        auto consider = [&](const ComponentPoolBase* pool) {
+            if (!pool) {
+                missing = true;
+            } else if (!smallest || pool->size() < smallest->size()) {
+                smallest = pool;
+            }
+        };
+        (consider(std::get<ComponentPool<Ts>*>(m_Pools)), ...);
+        return missing ? nullptr : smallest;
+    }
+
+    std::tuple<ComponentPool<Ts>*...> m_Pools;
+};
+
+// Owns the entities and one component pool per component type, created on first use.
+// Not thread safe; systems that fan out to workers should collect their work from a view first.
+class Registry {
+public:
+    Entity create();
+    // Removes every component of the entity and frees its slot for reuse
+    void destroy(Entity entity);
+    bool valid(Entity entity) const;
+    size_t alive() const;
+
+    // Throws when the entity was destroyed or never created, since a component on it would outlive every handle
+    template <typename T, typename... Args>
+    T& emplace(Entity entity, Args&&... args) {
+        if (!valid(entity)) {
+            throw std::invalid_argument("Registry: emplace on an invalid entity");
+        }
+        return pool<T>().emplace(entity, std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    void remove(Entity entity) {
+        if (ComponentPool<T>* components = findPool<T>()) components->remove(entity);
+    }
+
+    template <typename T>
+    bool has(Entity entity) const {
+        const ComponentPool<T>* components = findPool<T>();
+        return components && components->contains(entity);
+    }
+
+    // The entity must have the component
+    template <typename T>
+    T& get(Entity entity) {
+        return findPool<T>()->get(entity);
+    }
+
+    template <typename T>
+    const T& get(Entity entity) const {
+        return findPool<T>()->get(entity);
+    }
+
+    template <typename T>
+    T* tryGet(Entity entity) {
+        ComponentPool<T>* components = findPool<T>();
+        return components ? components->tryGet(entity) : nullptr;
+    }
+
+    template <typename... Ts>
+    View<Ts...> view() {
+        return View<Ts...>(findPool<Ts>()...);
+    }
+
+private:
+    static size_t nextTypeId();
+
+    template <typename T>
+    static size_t typeId() {
+        static const size_t id = nextTypeId();
+        return id;
+    }
+
+    template <typename T>
+    ComponentPool<T>& pool() {
+        size_t id = typeId<T>();
+        if (id >= m_Pools.size()) {
+            m_Pools.resize(id + 1);
+        }
+        if (!m_Pools[id]) {
+            m_Pools[id] = std::make_unique<ComponentPool<T>>();
+        }
+        return static_cast<ComponentPool<T>&>(*m_Pools[id]);
+    }
+
+    template <typename T>
+    ComponentPool<T>* findPool() const {
+        size_t id = typeId<T>();
+        return id < m_Pools.size() ? static_cast<ComponentPool<T>*>(m_Pools[id].get()) : nullptr;
+    }
+
+    std::vector<std::unique_ptr<ComponentPoolBase>> m_Pools; // Indexed by component type id
+    std::vector<Entity> m_Entities;                          // Handle per slot, NULL_ENTITY while the slot is free
+    std::vector<uint32_t> m_Versions;                        // Version the slot's current or next entity gets
+    std::vector<uint32_t> m_FreeSlots;
+};
+
+#endif
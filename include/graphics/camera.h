@@ -4,7 +4,7 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 
-#include "physics/aabb.h"
+#include "ecs/registry.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,6 +12,8 @@
 
 class World;
 
+// View and first-person controls of an entity, which gets its position from its Transform, and moves and
+// collides through its Velocity and Collider
 class Camera {
     
 public:
@@ -20,13 +22,9 @@ public:
 
     GLFWwindow* window();
 
-    glm::vec3 cameraPos   = glm::vec3(8.0f, 68.0f, 8.0f);
     glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
     glm::vec3 cameraUp    = glm::vec3(0.0f, 1.0f,  0.0f);
 
-    glm::vec3 velocity = glm::vec3(0.0f);
-    AABB boundingBox{cameraPos, glm::vec3(0.8f, 3.3f, 0.8f)};
-
     float yaw = -90.0f;
     float pitch = 0.0f;
 
@@ -35,14 +33,13 @@ public:
     bool firstMouse = true;
 
     void mouse_callback(double xpos, double ypos);
-    void processInput(GLFWwindow *window, World& world, float deltaTime);
-    void updatePosition(World& world, float deltaTime);
+    // Sets the horizontal velocity of `entity` from the keyboard and edits the block it looks at
+    void processInput(GLFWwindow *window, World& world, Registry& registry, Entity entity, float deltaTime);
 
 private:
-    bool onGround = false;
-
     bool leftMouseButtonPressed = false;
     bool rightMouseButtonPressed = false;
+    bool meshingKeyPressed = false;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Axis-aligned boxes stored as one array per component, so culling runs over plain float arrays
+struct BoxList {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    void clear();
+    void push(const glm::vec3& min, const glm::vec3& max);
+    size_t size() const { return minX.size(); }
+};
+
+// View frustum planes taken from a combined projection * view matrix
+class Frustum {
+public:
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    // Sets visible[i] to 1 when box i is at least partly inside the frustum, 0 otherwise
+    void cull(const BoxList& boxes, std::vector<uint8_t>& visible) const;
+
+private:
+    // Left, right, bottom, top, near, far; normals point inwards
+    glm::vec4 m_Planes[6];
+};
+
+#endif
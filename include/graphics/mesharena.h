@@ -0,0 +1,77 @@
+#ifndef MESHARENA_H
+#define MESHARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Texture unit the chunk shader reads mesh origins from, next to the atlas on unit 0
+constexpr unsigned int CHUNK_ORIGIN_TEXTURE_UNIT = 1;
+
+// Range of vertices a mesh owns inside a MeshArena
+struct MeshAllocation {
+    uint32_t firstVertex = 0;
+    uint32_t vertexCapacity = 0; // 0 when nothing is allocated
+};
+
+struct MeshArenaStats {
+    size_t capacityBytes = 0;
+    size_t allocatedBytes = 0; // Held by live ranges, including the slack kept for rebuilds
+    size_t freeRanges = 0;
+    size_t largestFreeBytes = 0;
+    int growCount = 0;
+
+    // 0 while the free space is one range, towards 1 as it splits into small pieces
+    float fragmentation() const;
+};
+
+// One vertex buffer and VAO shared by every chunk mesh, holding packed 32-bit chunk vertices.
+// Ranges come from a first-fit free list that merges neighbouring free ranges; when nothing fits
+// the buffer doubles and keeps its contents. GL objects are created on the first upload.
+//
+// Each range also records an origin for its mesh in a buffer texture with one texel per granule,
+// so a vertex shader finds the origin of any vertex at texelFetch(origins, gl_VertexID / RANGE_GRANULE).
+class MeshArena {
+public:
+    // Ranges start and end on multiples of this many vertices
+    static constexpr uint32_t RANGE_GRANULE = 128;
+
+    explicit MeshArena(size_t initialVertices = 1 << 20);
+    ~MeshArena();
+
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+
+    // Writes the vertices and their origin into the allocation, keeping its range when they fit and moving it otherwise
+    void upload(MeshAllocation& allocation, const std::vector<uint32_t>& vertices, const glm::ivec2& origin);
+    void release(MeshAllocation& allocation);
+
+    // Binds the shared VAO, and the origin buffer texture to `originTextureUnit`.
+    // Draw each mesh with its firstVertex as the base vertex.
+    void bind(unsigned int originTextureUnit) const;
+
+    MeshArenaStats getStats() const;
+
+private:
+    void createBuffers();
+    bool allocate(uint32_t vertices, MeshAllocation& allocation);
+    void addFreeRange(uint32_t first, uint32_t count);
+    void grow(size_t minimumVertices);
+    void writeOrigin(const MeshAllocation& allocation, const glm::ivec2& origin);
+
+    unsigned int m_VAO = 0;
+    unsigned int m_VBO = 0;
+    unsigned int m_EBO = 0;
+    unsigned int m_OriginBuffer = 0;
+    unsigned int m_OriginTexture = 0;
+    size_t m_CapacityVertices;
+    size_t m_AllocatedVertices = 0;
+    int m_GrowCount = 0;
+
+    // First vertex -> length of each free range
+    std::map<uint32_t, uint32_t> m_FreeRanges;
+};
+
+#endif
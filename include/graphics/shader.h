@@ -2,6 +2,7 @@
 #define SHADER_H
 
 #include <string>
+#include <unordered_map>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
@@ -16,11 +17,22 @@ public:
     // Use/activate the shader
     void use();
 
+    // Locations are looked up once after linking; unknown names give -1, which GL ignores
+    int getUniformLocation(const std::string &name) const;
+
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
     void setInt(const std::string &name, int value) const;
+    void setMat4(int location, const glm::mat4 &mat) const;
+    void setInt(int location, int value) const;
+
+    // Connects a uniform block of this program to a uniform buffer binding point, if the program uses it
+    void bindUniformBlock(const char* blockName, unsigned int bindingPoint) const;
 
 private:
     void checkCompileErrors(unsigned int shader, std::string type);
+    void cacheUniformLocations();
+
+    std::unordered_map<std::string, int> m_UniformLocations;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef UNIFORMBUFFER_H
+#define UNIFORMBUFFER_H
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Binding point of the Camera uniform block shared by every program
+constexpr unsigned int CAMERA_UNIFORM_BINDING = 0;
+
+// Matches `layout(std140) uniform Camera` in the shaders
+struct CameraUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+};
+
+// Uniform buffer object attached to a fixed binding point, so every program reading that
+// block sees the same data after a single update
+class UniformBuffer {
+public:
+    UniformBuffer(size_t size, unsigned int bindingPoint);
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    void update(const void* data, size_t size);
+
+private:
+    unsigned int m_Buffer = 0;
+};
+
+#endif
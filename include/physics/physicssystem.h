@@ -2,11 +2,15 @@
 #define PHYSICSSYSTEM_H
 
 #include "world/world.h"
+#include "ecs/registry.h"
 #include "physics/aabb.h"
 #include <glm/glm.hpp>
 
 namespace PhysicsSystem {
     void resolveCollision(World& world, AABB& entityAABB, glm::vec3& position, glm::vec3& velocity, bool& onGround, float deltaTime);
+
+    // Applies gravity to and moves every entity with a Transform, Velocity and Collider
+    void update(Registry& registry, World& world, float deltaTime);
 }
 
 #endif
\ No newline at end of file
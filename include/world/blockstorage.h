@@ -0,0 +1,55 @@
+#ifndef BLOCKSTORAGE_H
+#define BLOCKSTORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "block.h"
+#include "world/voxelarena.h"
+
+// Palette-compressed array of blocks. Each entry is an index into a small palette of the
+// block types present, bit-packed into 64-bit words. The index width grows through
+// 0, 1, 2, 4 and 8 bits as new types appear, so entries never straddle a word. A storage
+// holding a single block type keeps just that value and allocates nothing. The palette and
+// index array come from `arena` when one is given, otherwise from the heap.
+class BlockStorage {
+public:
+    BlockStorage() = default;
+    explicit BlockStorage(int size, BlockID fill = BlockID::Air, VoxelArena* arena = nullptr);
+
+    BlockID get(int index) const {
+        if (m_BitsPerEntry == 0) {
+            return m_Uniform;
+        }
+        int bit = index * m_BitsPerEntry;
+        return m_Palette[(m_Data[bit >> 6] >> (bit & 63)) & m_EntryMask];
+    }
+
+    void set(int index, BlockID block);
+
+    // Resets every entry to `block`, dropping the palette and index array but keeping their memory for reuse
+    void fill(BlockID block);
+    // Drops palette entries that are no longer used, shrinking the index width where possible
+    void compact();
+
+    bool isUniform() const;
+    int bitsPerEntry() const;
+    size_t paletteSize() const;
+    // Bytes the storage's blocks take, including the palette and the index array. Memory kept for reuse
+    // after a fill or a narrower resize is not counted
+    size_t memoryUsage() const;
+
+private:
+    int paletteIndexOf(BlockID block);
+    // Rewrites every index at the new width, mapping each through `remap` when given
+    void resize(int bitsPerEntry, const uint8_t* remap = nullptr);
+
+    int m_Size = 0;
+    int m_BitsPerEntry = 0;
+    uint64_t m_EntryMask = 0;
+    BlockID m_Uniform = BlockID::Air; // The only block while m_BitsPerEntry is 0
+    std::vector<BlockID, VoxelAllocator<BlockID>> m_Palette;
+    std::vector<uint64_t, VoxelAllocator<uint64_t>> m_Data;
+};
+
+#endif
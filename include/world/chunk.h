@@ -1,20 +1,103 @@
 #ifndef CHUNK_H
 #define CHUNK_H
 
+#include <array>
+#include <cstdint>
+#include <utility>
 #include "block.h"
+#include "graphics/mesharena.h"
+#include "world/blockstorage.h"
 
 constexpr int CHUNK_WIDTH = 16;
 constexpr int CHUNK_HEIGHT = 256;
 constexpr int CHUNK_DEPTH = 16;
 
-struct Chunk {
-    BlockID blocks[CHUNK_WIDTH][CHUNK_HEIGHT][CHUNK_DEPTH];
+// Chunks are split into vertical 16x16x16 sections
+constexpr int SECTION_HEIGHT = 16;
+constexpr int SECTION_COUNT = CHUNK_HEIGHT / SECTION_HEIGHT;
+constexpr int SECTION_VOLUME = CHUNK_WIDTH * SECTION_HEIGHT * CHUNK_DEPTH;
+
+// Sets of sections are bitmasks with bit s for section s
+constexpr uint16_t ALL_SECTIONS = 0xFFFF;
+static_assert(SECTION_COUNT == 16, "section sets are 16-bit masks");
+
+// Index into Chunk::neighbours; flipping the lowest bit gives the opposite side
+enum ChunkNeighbour {
+    NEIGHBOUR_POS_X,
+    NEIGHBOUR_NEG_X,
+    NEIGHBOUR_POS_Z,
+    NEIGHBOUR_NEG_Z,
+    NEIGHBOUR_COUNT
+};
+
+// One row per block layer, with bit t set when the block t along the chunk side is solid.
+// Along an X side t is the z coordinate, along a Z side it is x, so opposite sides of adjacent chunks line up.
+using BorderMask = std::array<uint16_t, CHUNK_HEIGHT>;
 
-    unsigned int VAO = 0;
-    unsigned int VBO = 0;
+// Range of the world's mesh arena holding one section's vertices
+struct SectionMesh {
+    MeshAllocation allocation;
     int vertexCount = 0;
+    int indexCount = 0;
+};
+
+struct Chunk {
+    // Palette-compressed voxels per section, each laid out x-major then y then z.
+    // Sections of a single block type, like all-air sky, store just that value. Use getBlock/setBlock.
+    std::array<BlockStorage, SECTION_COUNT> sections;
+
+    // Meshed separately so an edit rebuilds only the sections it touches
+    std::array<SectionMesh, SECTION_COUNT> meshes;
+
+    // Sections to rebuild on the next remesh. Non-zero exactly while the chunk waits in the world's dirty queue.
+    uint16_t dirtySections = 0;
+
+    // Loaded chunks on each side, or nullptr; the world keeps these up to date as chunks load and unload
+    std::array<Chunk*, NEIGHBOUR_COUNT> neighbours{};
+
+    // Solid blocks on each side, see ChunkSystem::updateBorderMasks
+    std::array<BorderMask, NEIGHBOUR_COUNT> borderMasks{};
+    // Per side, which of this chunk's border faces the neighbour hid when each section's last mesh job was
+    // scheduled, see ChunkSystem::recordBorderContacts
+    std::array<BorderMask, NEIGHBOUR_COUNT> meshedBorderContacts{};
+
+    // Every non-air block lies in [minHeight, maxHeight), see ChunkSystem::updateHeightBounds
+    int minHeight = 0;
+    int maxHeight = 0;
+
+    // Set while a mesh job for this chunk is queued or waiting for upload
+    bool meshPending = false;
+    unsigned long long meshTicket = 0;
+
+    Chunk() : Chunk(nullptr) {}
+
+    // Sections take their voxel memory from `arena`, or from the heap when it is null
+    explicit Chunk(VoxelArena* arena) {
+        sections.fill(BlockStorage(SECTION_VOLUME, BlockID::Air, arena));
+    }
+
+    // Returns to the default state of an all-air chunk, keeping the memory the sections hold, and their arena, for reuse
+    void reset() {
+        std::array<BlockStorage, SECTION_COUNT> kept = std::move(sections);
+        *this = Chunk();
+        sections = std::move(kept);
+        for (BlockStorage& section : sections) {
+            section.fill(BlockID::Air);
+        }
+    }
+
+    BlockID getBlock(int x, int y, int z) const {
+        return sections[y / SECTION_HEIGHT].get((x * SECTION_HEIGHT + y % SECTION_HEIGHT) * CHUNK_DEPTH + z);
+    }
+
+    void setBlock(int x, int y, int z, BlockID type) {
+        sections[y / SECTION_HEIGHT].set((x * SECTION_HEIGHT + y % SECTION_HEIGHT) * CHUNK_DEPTH + z, type);
+    }
 
-    bool isDirty = true;
+    // True when the section holds nothing but air, so meshing and collision can skip it
+    bool isSectionEmpty(int section) const {
+        return sections[section].isUniform() && sections[section].get(0) == BlockID::Air;
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
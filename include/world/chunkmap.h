@@ -0,0 +1,105 @@
+#ifndef CHUNKMAP_H
+#define CHUNKMAP_H
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "world/chunk.h"
+#include "world/chunkpool.h"
+
+// Using glm::ivec2 for chunk coordinates
+using ChunkCoord = glm::ivec2;
+
+struct ivec2_compare {
+    bool operator()(const glm::ivec2& a, const glm::ivec2& b) const {
+        if (a.x < b.x) return true;
+        if (a.x > b.x) return false;
+        if (a.y < b.y) return true;
+        return false;
+    }
+};
+
+// HashMap grows without limit. RingBuffer holds a fixed square of chunks around the player,
+// indexed by coordinate modulo the grid size, so lookups never probe.
+enum class ChunkStorageMode {
+    HashMap,
+    RingBuffer
+};
+
+// Map from chunk coordinate to chunk, with two storage modes:
+// - HashMap: open addressing keyed by both coordinates packed into 64 bits, with linear
+//   probing and backward-shift deletion, so there are no tombstones. Sized up front to hold a
+//   square of ringSize chunks on a side without growing.
+// - RingBuffer: a toroidal grid with sides of at least ringSize, rounded up to a power of two.
+//   Coordinates a grid side apart share a slot, so callers must erase chunks that left the
+//   window before inserting new ones.
+// Chunks never move while they are in the map. Erased chunks go back to the pool they came from, and
+// emplace takes chunks from `pool` when one is given, so streaming recycles chunks in either mode.
+class ChunkMap {
+public:
+    explicit ChunkMap(ChunkStorageMode mode = ChunkStorageMode::HashMap, int ringSize = 0, ChunkPool* pool = nullptr);
+
+    Chunk* find(const ChunkCoord& coord);
+    const Chunk* find(const ChunkCoord& coord) const;
+    bool contains(const ChunkCoord& coord) const;
+
+    // Takes the chunk, replacing any chunk already stored at `coord`
+    Chunk& insert(const ChunkCoord& coord, PooledChunk chunk);
+    // Stores a chunk in its default state at `coord`
+    Chunk& emplace(const ChunkCoord& coord);
+    bool erase(const ChunkCoord& coord);
+
+    size_t size() const;
+    void clear();
+
+    static uint64_t packCoord(const ChunkCoord& coord);
+
+private:
+    struct Slot {
+        ChunkCoord coord;
+        PooledChunk chunk;
+        bool occupied = false;
+    };
+
+    template <typename SlotT, typename ChunkT>
+    class Iterator {
+    public:
+        Iterator(SlotT* slot, SlotT* end) : m_Slot(slot), m_End(end) { skipEmpty(); }
+
+        std::pair<const ChunkCoord&, ChunkT&> operator*() const { return {m_Slot->coord, *m_Slot->chunk}; }
+        Iterator& operator++() { ++m_Slot; skipEmpty(); return *this; }
+        bool operator!=(const Iterator& other) const { return m_Slot != other.m_Slot; }
+
+    private:
+        void skipEmpty() { while (m_Slot != m_End && !m_Slot->occupied) ++m_Slot; }
+
+        SlotT* m_Slot;
+        SlotT* m_End;
+    };
+
+public:
+    using iterator = Iterator<Slot, Chunk>;
+    using const_iterator = Iterator<const Slot, const Chunk>;
+
+    iterator begin() { return iterator(m_Slots.data(), m_Slots.data() + m_Slots.size()); }
+    iterator end() { return iterator(m_Slots.data() + m_Slots.size(), m_Slots.data() + m_Slots.size()); }
+    const_iterator begin() const { return const_iterator(m_Slots.data(), m_Slots.data() + m_Slots.size()); }
+    const_iterator end() const { return const_iterator(m_Slots.data() + m_Slots.size(), m_Slots.data() + m_Slots.size()); }
+
+private:
+    size_t slotFor(uint64_t key) const;
+    size_t ringSlotFor(const ChunkCoord& coord) const;
+    size_t findSlot(const ChunkCoord& coord) const;
+    void grow();
+
+    ChunkStorageMode m_Mode;
+    int m_RingSize;
+    ChunkPool* m_Pool;
+    std::vector<Slot> m_Slots;
+    size_t m_Size = 0;
+    size_t m_Mask = 0;
+};
+
+#endif
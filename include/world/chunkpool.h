@@ -0,0 +1,63 @@
+#ifndef CHUNKPOOL_H
+#define CHUNKPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "core/memoryregion.h"
+#include "world/chunk.h"
+#include "world/voxelarena.h"
+
+class ChunkPool;
+
+// Hands a chunk back to its pool, or deletes it when it did not come from one
+struct ChunkReleaser {
+    ChunkPool* pool = nullptr;
+    void operator()(Chunk* chunk) const;
+};
+
+using PooledChunk = std::unique_ptr<Chunk, ChunkReleaser>;
+
+struct ChunkPoolStats {
+    size_t capacity = 0;
+    size_t inUse = 0;
+    size_t heapChunks = 0; // Handed out past the capacity and not yet released
+    bool hugePages = false; // The kernel accepted the huge page advice for the pool's memory
+    VoxelArenaStats voxels;
+};
+
+// Fixed set of chunks recycled through a free list, so streaming reuses chunk objects, and the voxel memory their
+// sections keep, instead of returning them to the heap. The chunks, and a voxel arena their sections allocate from,
+// sit in blocks of memory that can be backed by transparent huge pages on Linux. Acquiring past the capacity falls
+// back to the heap for the chunk object, though its sections still use the arena while it has room.
+// Safe to use from several threads, so workers can acquire the chunks they generate into.
+class ChunkPool {
+public:
+    explicit ChunkPool(size_t capacity, bool hugePages = false);
+    ~ChunkPool();
+
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    // A chunk in its default state, see Chunk::reset
+    PooledChunk acquire();
+    void release(Chunk* chunk);
+
+    ChunkPoolStats getStats() const;
+
+private:
+    bool owns(const Chunk* chunk) const;
+
+    // Declared first so it outlives every chunk, including snapshot copies that share it
+    VoxelArena m_VoxelArena;
+    MemoryRegion m_Region;
+    Chunk* m_Chunks = nullptr;
+    size_t m_Capacity;
+
+    mutable std::mutex m_Mutex;
+    std::vector<Chunk*> m_Free; // Most recently released last, so reuse hits warm memory
+    size_t m_HeapChunks = 0;
+};
+
+#endif
@@ -3,11 +3,52 @@
 
 #include "chunk.h"
 #include "world/FastNoiseLite.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Naive emits one quad per exposed face, Greedy merges coplanar faces with the same texture
+enum class MeshingMode {
+    Naive,
+    Greedy
+};
+
+// Chunk mesh vertex: local position, face and atlas tile packed into 32 bits
+using ChunkVertex = uint32_t;
+
+// Vertices of each section of a chunk
+using SectionMeshData = std::array<std::vector<ChunkVertex>, SECTION_COUNT>;
+
+// The float vertex the packed format replaced, as its two attributes were laid out, kept to compare sizes
+struct UnpackedChunkVertex {
+    float position[3];
+    float atlasUV[2];
+};
+constexpr int UNPACKED_VERTEX_BYTES = sizeof(UnpackedChunkVertex);
+
+// Largest number of quads a chunk mesh can hold: every other block solid with all six faces exposed
+constexpr int MAX_CHUNK_QUADS = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH / 2 * 6;
 
 namespace ChunkSystem {
     void generate(Chunk& chunk, int chunkX, int chunkZ, FastNoiseLite& noise, FastNoiseLite& detailNoise);
-    void buildMesh(Chunk& chunk, Chunk* neighbourPosX, Chunk* neighbourNegX, Chunk* neighbourPosY, Chunk* neighbourNegY);
-    void unloadMesh(Chunk& chunk);
+    // Recomputes the chunk's minHeight/maxHeight from its blocks, skipping all-air sections
+    void updateHeightBounds(Chunk& chunk);
+    // Recomputes the chunk's borderMasks from its blocks
+    void updateBorderMasks(Chunk& chunk);
+    // True when the blocks of a section on `side` that are solid in both the chunk and `neighbour`, whose faces the
+    // mesher hides, differ from those recorded for the section's mesh. A missing neighbour touches nothing.
+    bool borderContactsChanged(const Chunk& chunk, int side, int section, const Chunk* neighbour);
+    // Records the section's contacts with its current neighbours on every side, for borderContactsChanged
+    void recordBorderContacts(Chunk& chunk, int section);
+    // CPU side of meshing, touches no GL state so it can run on a worker thread. Builds the whole chunk as one mesh.
+    std::vector<ChunkVertex> buildMeshData(const Chunk& chunk, const Chunk* neighbourPosX, const Chunk* neighbourNegX, const Chunk* neighbourPosZ, const Chunk* neighbourNegZ, MeshingMode mode = MeshingMode::Greedy);
+    // Builds a separate mesh for each section in `sections`, bit s for section s, and leaves the others empty.
+    // Quads never cross a section boundary, so each section can be rebuilt on its own.
+    SectionMeshData buildSectionMeshData(const Chunk& chunk, const Chunk* neighbourPosX, const Chunk* neighbourNegX, const Chunk* neighbourPosZ, const Chunk* neighbourNegZ, uint16_t sections, MeshingMode mode = MeshingMode::Greedy);
+    // Uploads a built section mesh into the arena, replacing the previous one. Must run on the thread owning the GL context.
+    void uploadMesh(MeshArena& arena, Chunk& chunk, int section, int chunkX, int chunkZ, const std::vector<ChunkVertex>& vertices);
+    // Releases the meshes of every section
+    void unloadMesh(MeshArena& arena, Chunk& chunk);
 }
 
-#endif
\ No newline at end of file
+#endif
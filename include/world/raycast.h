@@ -1,17 +1,33 @@
 #ifndef RAYCAST_H
 #define RAYCAST_H
 
+#include "core/threadpool.h"
 #include "world/world.h"
 #include <glm/glm.hpp>
 #include <optional>
+#include <span>
 
 struct RaycastResult {
     glm::ivec3 blockPosition;
-    glm::ivec3 previousBlockPosition;
+    glm::ivec3 previousBlockPosition; // Empty block in front of the hit face
+    glm::ivec3 normal;                // Outward normal of the face the ray entered through
+    float distance;                   // Distance from the origin to the hit face
+};
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+    float maxDistance;
 };
 
 namespace RaycastSystem {
     std::optional<RaycastResult> cast(const World& world, const glm::vec3& origin, const glm::vec3& direction, float maxDistance);
+
+    // Casts every ray into the matching slot of `results`, which must be at least as long as `rays`.
+    // Work is split across `pool` and the calling thread, which blocks until all rays are done.
+    // The world must not be modified until the call returns.
+    void castBatch(const World& world, std::span<const Ray> rays, std::span<std::optional<RaycastResult>> results,
+                   ThreadPool* pool = nullptr);
 }
 
 #endif
\ No newline at end of file
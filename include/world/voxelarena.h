@@ -0,0 +1,93 @@
+#ifndef VOXELARENA_H
+#define VOXELARENA_H
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include "core/memoryregion.h"
+
+struct VoxelArenaStats {
+    size_t capacity = 0;
+    size_t inUse = 0;     // Bytes handed out from the region, rounded up to their size class
+    size_t heapBytes = 0; // Handed out from the heap because the region was full or the request too large
+};
+
+// Memory for the palettes and index arrays of block storages, carved from one region that can be backed by
+// transparent huge pages. Requests are rounded up to a power of two size class, and freed blocks go on a free
+// list per class, so a streaming world settles on recycling the same blocks. Safe to use from several threads,
+// since snapshot copies of chunks are freed on the mesh workers.
+class VoxelArena {
+public:
+    VoxelArena(size_t bytes, bool hugePages);
+
+    VoxelArena(const VoxelArena&) = delete;
+    VoxelArena& operator=(const VoxelArena&) = delete;
+
+    void* allocate(size_t bytes);
+    // `bytes` must be the size the block was allocated with
+    void deallocate(void* pointer, size_t bytes);
+
+    bool hugePages() const { return m_Region.hugePages(); }
+    VoxelArenaStats getStats() const;
+
+private:
+    // 64 bytes up to 4 KiB, the largest index array a 16x16x16 section needs
+    static constexpr int MIN_CLASS_SHIFT = 6;
+    static constexpr int CLASS_COUNT = 7;
+
+    // -1 when the request is larger than every class
+    static int sizeClass(size_t bytes);
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    MemoryRegion m_Region;
+
+    mutable std::mutex m_Mutex;
+    size_t m_Used = 0; // Bytes of the region carved into blocks so far
+    std::array<FreeBlock*, CLASS_COUNT> m_Free{};
+    size_t m_InUse = 0;
+    size_t m_HeapBytes = 0;
+};
+
+// Standard allocator over a voxel arena, or over the heap when it has none. Containers take the allocator along
+// when they are assigned or swapped, so a block storage moved into a pooled chunk keeps freeing into its own arena.
+template <typename T>
+struct VoxelAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    VoxelArena* arena = nullptr;
+
+    VoxelAllocator() = default;
+    explicit VoxelAllocator(VoxelArena* arena) : arena(arena) {}
+    template <typename U>
+    VoxelAllocator(const VoxelAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        if (!arena) {
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+        return static_cast<T*>(arena->allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        if (!arena) {
+            ::operator delete(pointer);
+            return;
+        }
+        arena->deallocate(pointer, count * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const VoxelAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+};
+
+#endif
@@ -1,44 +1,159 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include <glm/glm.hpp>
+#include "core/threadpool.h"
 #include "world/chunk.h"
-#include "graphics/shader.h"
+#include "world/chunkmap.h"
+#include "world/chunkpool.h"
+#include "world/chunksystem.h"
+#include "graphics/frustum.h"
+#include "graphics/mesharena.h"
 #include "world/FastNoiseLite.h"
 
-struct ivec2_compare {
-    bool operator()(const glm::ivec2& a, const glm::ivec2& b) const {
-        if (a.x < b.x) return true;
-        if (a.x > b.x) return false;
-        if (a.y < b.y) return true;
-        return false;
-    }
-};
-
-// Using glm::ivec2 for chunk coordinates
-using ChunkCoord = glm::ivec2;
-
 class World {
 public:
-    World(FastNoiseLite& noise, FastNoiseLite& detailNoise);
+    // Chunks are generated and meshed on `workerThreads` workers, 0 picks one per spare core.
+    // RingBuffer storage keeps the loaded square of chunks in a fixed toroidal grid.
+    // `hugePageChunks` asks for the chunk pool and its voxel arena to be backed by transparent huge pages where the OS supports it.
+    World(FastNoiseLite& noise, FastNoiseLite& detailNoise, unsigned int workerThreads = 0,
+          ChunkStorageMode storageMode = ChunkStorageMode::HashMap, bool hugePageChunks = false);
     void createChunk(int x, int z);
 
-    void updateChunksAroundPlayer(const glm::vec3& position);
+    // Streams chunks in and out as the player crosses chunk borders. Missing chunks are generated nearest first,
+    // favouring those in `viewDirection`, and generated chunks are added to the world within the load budget
+    void updateChunksAroundPlayer(const glm::vec3& position, const glm::vec3& viewDirection = glm::vec3(0.0f));
     void setBlock(int worldX, int worldY, int worldZ, BlockID type);
     BlockID getBlock(int worldX, int worldY, int worldZ) const;
+    // Loaded chunk at a chunk coordinate, or nullptr
+    const Chunk* getChunk(const ChunkCoord& coord) const;
+    // True when the section holding the block is all air or not loaded, so getBlock returns Air throughout it
+    bool isSectionEmpty(int worldX, int worldY, int worldZ) const;
     
+    // Schedules mesh jobs for dirty chunks and uploads finished meshes within the upload budget
     void update();
-    void render(Shader& shader) const;
+    // Draws the chunks whose bounds intersect the view frustum with the program in use, which must sample the
+    // chunk origins from CHUNK_ORIGIN_TEXTURE_UNIT
+    void render(const glm::mat4& viewProjection);
+
+    struct RenderStats {
+        int chunksDrawn = 0;
+        int chunksCulled = 0;
+        int drawCalls = 0;
+    };
+    // Counts from the last render call
+    const RenderStats& getRenderStats() const;
+    // Occupancy and fragmentation of the buffer shared by all chunk meshes
+    MeshArenaStats getMeshArenaStats() const;
+    // Chunk objects in use, including those still being generated
+    ChunkPoolStats getChunkPoolStats() const;
+
+    // Caps GPU uploads per frame; at least one mesh is uploaded each frame regardless
+    void setMeshUploadBudget(size_t maxBytesPerFrame, int maxChunksPerFrame);
+
+    // Caps the main thread time spent adding generated chunks each frame; at least one is added regardless
+    void setChunkLoadBudget(float milliseconds);
+
+    // Switching the mesher rebuilds every loaded chunk and reports the result on the next update
+    void setMeshingMode(MeshingMode mode);
+    MeshingMode getMeshingMode() const;
 
     constexpr static float GRAVITY = 30.0f;
 
 private:
-    std::map<ChunkCoord, Chunk, ivec2_compare> m_Chunks;
-    const int RENDER_DISTANCE = 9;
-    const int UNLOAD_DISTANCE = 11;
+    void moveStreamCentre(const ChunkCoord& playerChunk);
+    void requestChunk(const ChunkCoord& coord);
+    void dispatchChunkLoads(const ChunkCoord& playerChunk, const glm::vec3& viewDirection);
+    void collectGeneratedChunks(const ChunkCoord& playerChunk);
+    void linkNeighbours(const ChunkCoord& coord, Chunk& chunk);
+    void unloadChunk(const ChunkCoord& coord);
+    void markDirty(const ChunkCoord& coord, Chunk& chunk, uint16_t sections);
+    void scheduleMeshJobs();
+    void uploadBuiltMeshes();
+
+    struct ChunkLoad {
+        ChunkCoord coord;
+        float priority; // Lower loads first
+    };
+
+    struct BuiltMesh {
+        ChunkCoord coord;
+        unsigned long long ticket;
+        uint16_t sections; // The sections rebuilt; the others keep their current mesh
+        SectionMeshData vertices;
+    };
+
+    static constexpr int RENDER_DISTANCE = 9;
+    static constexpr int UNLOAD_DISTANCE = 11;
+    // Room for the loaded square plus chunks generated ahead of being added to it
+    static constexpr size_t CHUNK_POOL_HEADROOM = 64;
+
+    // Declared before everything holding chunks, so they are all released before it goes
+    ChunkPool m_ChunkPool;
+    ChunkMap m_Chunks;
     FastNoiseLite& m_noise;
     FastNoiseLite& m_detailNoise;
+
+    MeshingMode m_MeshingMode = MeshingMode::Greedy;
+    bool m_ReportMeshStats = false;
+    std::chrono::high_resolution_clock::time_point m_MeshStatsStart;
+    std::atomic<long long> m_MeshBuildMicroseconds = 0;
+
+    // Chunks waiting for a remesh, each queued once while it has dirty sections. Entries whose chunk was
+    // unloaded since are skipped, and chunks whose previous mesh is still in flight wait here for it to land
+    std::vector<ChunkCoord> m_DirtyChunks;
+
+    // Meshes built by the workers, and meshes waiting for room in the upload budget
+    std::vector<BuiltMesh> m_BuiltMeshes;
+    std::mutex m_BuiltMutex;
+    std::deque<BuiltMesh> m_ReadyMeshes;
+    unsigned long long m_NextMeshTicket = 0;
+    int m_MeshJobsInFlight = 0;
+    size_t m_MaxUploadBytesPerFrame = 1024 * 1024;
+    int m_MaxUploadChunksPerFrame = 32;
+
+    // Chunk the loaded square is centred on, set by the first updateChunksAroundPlayer call
+    ChunkCoord m_StreamCentre;
+    bool m_HasStreamCentre = false;
+
+    // Every requested chunk not yet added to the world, whether queued, generating or waiting for the load budget
+    std::set<ChunkCoord, ivec2_compare> m_PendingChunks;
+    // Chunks waiting for a worker, as a min-heap on priority. Only a few generation jobs are handed to the pool
+    // at a time, so the order can still change when the player moves or turns
+    std::vector<ChunkLoad> m_LoadQueue;
+    bool m_LoadQueueStale = false;
+    glm::vec2 m_LoadQueueView = glm::vec2(0.0f);
+    int m_ChunkJobsInFlight = 0;
+    float m_ChunkLoadBudgetMilliseconds = 2.0f;
+
+    // Chunks generated by the workers, and chunks waiting for room in the load budget
+    std::vector<std::pair<ChunkCoord, PooledChunk>> m_GeneratedChunks;
+    std::mutex m_GeneratedMutex;
+    std::deque<std::pair<ChunkCoord, PooledChunk>> m_ReadyChunks;
+
+    // Single vertex buffer holding every chunk mesh
+    MeshArena m_MeshArena;
+
+    // Per-frame draw candidates, kept between frames to reuse their storage
+    std::vector<const Chunk*> m_DrawChunks;
+    BoxList m_DrawBounds;
+    std::vector<uint8_t> m_DrawVisible;
+    std::vector<int> m_DrawCounts;
+    std::vector<const void*> m_DrawIndexOffsets;
+    std::vector<int> m_DrawBaseVertices;
+    RenderStats m_RenderStats;
+
+    // Declared last so workers are joined before the state they write to is destroyed
+    ThreadPool m_Workers;
 };
 
 #endif
\ No newline at end of file
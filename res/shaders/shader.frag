@@ -1,10 +1,16 @@
 #version 330 core
 out vec4 FragColor;
 
+// Texture coordinates in blocks, so merged faces repeat their atlas tile once per block
 in vec2 TexCoords;
+flat in vec2 TileOrigin;
 
 uniform sampler2D texture_atlas;
 
+const float ATLAS_STEP = 1.0 / 2.0;
+
 void main() {
-    FragColor = texture(texture_atlas, TexCoords);
-}
\ No newline at end of file
+    vec2 atlasCoords = TileOrigin + fract(TexCoords) * ATLAS_STEP;
+    // Derivatives of the unwrapped coordinates keep mipmap selection stable across tile seams
+    FragColor = textureGrad(texture_atlas, atlasCoords, dFdx(TexCoords) * ATLAS_STEP, dFdy(TexCoords) * ATLAS_STEP);
+}
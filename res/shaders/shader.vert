@@ -1,14 +1,41 @@
 #version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec2 aTexCoords;
+// Packed chunk vertex, see packVertex in chunksystem.cpp
+layout (location = 0) in uint aVertex;
 
 out vec2 TexCoords;
+flat out vec2 TileOrigin;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Block origin of each mesh arena granule, see MeshArena
+uniform isamplerBuffer chunkOrigins;
+// Shared by every program, updated once per frame
+layout(std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+};
+
+const uint ATLAS_TILES_PER_ROW = 2u;
+const float ATLAS_STEP = 1.0 / 2.0;
+const int ARENA_RANGE_GRANULE = 128;
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    TexCoords = aTexCoords;
-}
\ No newline at end of file
+    vec3 aPos = vec3(float(aVertex & 31u), float((aVertex >> 5u) & 511u), float((aVertex >> 14u) & 31u));
+    uint face = (aVertex >> 19u) & 7u;
+    uint tile = (aVertex >> 22u) & 255u;
+
+    // Texture coordinates in blocks, oriented per face: +Y, -Y, +X, -X, +Z, -Z
+    if (face < 2u) {
+        TexCoords = vec2(aPos.x, -aPos.z);
+    } else if (face == 2u) {
+        TexCoords = vec2(-aPos.z, -aPos.y);
+    } else if (face == 3u) {
+        TexCoords = vec2(aPos.z, -aPos.y);
+    } else if (face == 4u) {
+        TexCoords = vec2(aPos.x, -aPos.y);
+    } else {
+        TexCoords = vec2(-aPos.x, -aPos.y);
+    }
+
+    TileOrigin = vec2(float(tile % ATLAS_TILES_PER_ROW), float(tile / ATLAS_TILES_PER_ROW)) * ATLAS_STEP;
+    ivec2 chunkOrigin = texelFetch(chunkOrigins, gl_VertexID / ARENA_RANGE_GRANULE).xy;
+    gl_Position = projection * view * vec4(aPos + vec3(chunkOrigin.x, 0.0, chunkOrigin.y), 1.0);
+}
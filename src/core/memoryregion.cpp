@@ -0,0 +1,35 @@
+#include "core/memoryregion.h"
+#include <cstdlib>
+#include <new>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+    const size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+    const size_t MIN_ALIGNMENT = 64; // A cache line
+}
+
+MemoryRegion::MemoryRegion(size_t bytes, bool hugePages) {
+    // aligned_alloc needs the size to be a multiple of the alignment
+    size_t alignment = hugePages ? HUGE_PAGE_BYTES : MIN_ALIGNMENT;
+    m_Size = (bytes + alignment - 1) / alignment * alignment;
+    if (m_Size == 0) {
+        return;
+    }
+
+    m_Data = std::aligned_alloc(alignment, m_Size);
+    if (!m_Data) {
+        throw std::bad_alloc();
+    }
+
+#ifdef __linux__
+    if (hugePages) {
+        m_HugePages = madvise(m_Data, m_Size, MADV_HUGEPAGE) == 0;
+    }
+#endif
+}
+
+MemoryRegion::~MemoryRegion() {
+    std::free(m_Data);
+}
@@ -0,0 +1,51 @@
+#include "ecs/registry.h"
+#include <atomic>
+#include <stdexcept>
+
+size_t Registry::nextTypeId() {
+    static std::atomic<size_t> next = 0;
+    return next++;
+}
+
+Entity Registry::create() {
+    uint32_t index;
+    if (!m_FreeSlots.empty()) {
+        index = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    } else {
+        if (m_Entities.size() > ENTITY_INDEX_MASK) {
+            throw std::length_error("Registry: out of entity slots");
+        }
+        index = (uint32_t)m_Entities.size();
+        m_Entities.push_back(NULL_ENTITY);
+        m_Versions.push_back(0);
+    }
+
+    m_Entities[index] = (m_Versions[index] << ENTITY_INDEX_BITS) | index;
+    return m_Entities[index];
+}
+
+void Registry::destroy(Entity entity) {
+    if (!valid(entity)) return;
+
+    for (const std::unique_ptr<ComponentPoolBase>& pool : m_Pools) {
+        if (pool) pool->remove(entity);
+    }
+
+    // The slot's next entity gets a new version, so this handle stops matching it
+    uint32_t index = entityIndex(entity);
+    m_Versions[index] = (m_Versions[index] + 1) & (NULL_ENTITY >> ENTITY_INDEX_BITS);
+    // The one handle that would read as NULL_ENTITY is skipped
+    if (((m_Versions[index] << ENTITY_INDEX_BITS) | index) == NULL_ENTITY) m_Versions[index] = 0;
+    m_Entities[index] = NULL_ENTITY;
+    m_FreeSlots.push_back(index);
+}
+
+bool Registry::valid(Entity entity) const {
+    uint32_t index = entityIndex(entity);
+    return entity != NULL_ENTITY && index < m_Entities.size() && m_Entities[index] == entity;
+}
+
+size_t Registry::alive() const {
+    return m_Entities.size() - m_FreeSlots.size();
+}
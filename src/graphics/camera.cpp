@@ -2,8 +2,8 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include "graphics/camera.h"
+#include "ecs/components.h"
 #include "world/world.h"
-#include "physics/physicssystem.h"
 #include "world/raycast.h"
 
 #include <glm/glm.hpp>
@@ -46,18 +46,22 @@ void Camera::mouse_callback(double xpos, double ypos) {
     cameraFront = glm::normalize(front);
 }
 
-void Camera::processInput(GLFWwindow *window, World& world, float deltaTime) {
+void Camera::processInput(GLFWwindow *window, World& world, Registry& registry, Entity entity, float deltaTime) {
     // Close window on escape
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
+    const glm::vec3& cameraPos = registry.get<Transform>(entity).position;
+    glm::vec3& velocity = registry.get<Velocity>(entity).linear;
+    Collider& collider = registry.get<Collider>(entity);
+
     velocity.x = 0.0f;
     velocity.z = 0.0f;
 
     if(glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
         if (velocity.y == 0.0f) {
             velocity.y += 10.0f;
-            onGround = false;
+            collider.onGround = false;
         }
     }
 
@@ -105,18 +109,23 @@ void Camera::processInput(GLFWwindow *window, World& world, float deltaTime) {
                 AABB newBlockAABB(newBlockCenter, glm::vec3(1.0f));
 
                 // If not, place the block
-                if (!boundingBox.intersects(newBlockAABB)) {
+                if (!collider.box.intersects(newBlockAABB)) {
                     world.setBlock(hit->previousBlockPosition.x, hit->previousBlockPosition.y, hit->previousBlockPosition.z, BlockID::Stone);
                 }
             }
         }
     } else {
         rightMouseButtonPressed = false;
-    }    
-}
-
-void Camera::updatePosition(World& world, float deltaTime) {
-    velocity.y -= World::GRAVITY * deltaTime;
+    }
 
-    PhysicsSystem::resolveCollision(world, boundingBox, cameraPos, velocity, onGround, deltaTime);
-}
\ No newline at end of file
+    // M toggles between the naive and greedy mesher
+    if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
+        if (!meshingKeyPressed) {
+            meshingKeyPressed = true;
+            MeshingMode mode = world.getMeshingMode() == MeshingMode::Greedy ? MeshingMode::Naive : MeshingMode::Greedy;
+            world.setMeshingMode(mode);
+        }
+    } else {
+        meshingKeyPressed = false;
+    }
+}
@@ -0,0 +1,52 @@
+#include "graphics/frustum.h"
+
+void BoxList::clear() {
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+void BoxList::push(const glm::vec3& min, const glm::vec3& max) {
+    minX.push_back(min.x); minY.push_back(min.y); minZ.push_back(min.z);
+    maxX.push_back(max.x); maxY.push_back(max.y); maxZ.push_back(max.z);
+}
+
+namespace {
+
+// Branch-free multiply-add over the corner arrays, which the compiler vectorises
+void cullAgainstPlane(const glm::vec4& plane, const float* cornerX, const float* cornerY, const float* cornerZ,
+                      uint8_t* visible, size_t count) {
+    const float normalX = plane.x, normalY = plane.y, normalZ = plane.z, offset = plane.w;
+    for (size_t i = 0; i < count; ++i) {
+        float distance = normalX * cornerX[i] + normalY * cornerY[i] + normalZ * cornerZ[i] + offset;
+        visible[i] = visible[i] & (distance >= 0.0f ? 1 : 0);
+    }
+}
+
+} // namespace
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    // Gribb-Hartmann: each plane is the last row of the matrix plus or minus one of the others
+    glm::vec4 rowX(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    glm::vec4 rowY(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    glm::vec4 rowZ(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    glm::vec4 rowW(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    m_Planes[0] = rowW + rowX;
+    m_Planes[1] = rowW - rowX;
+    m_Planes[2] = rowW + rowY;
+    m_Planes[3] = rowW - rowY;
+    m_Planes[4] = rowW + rowZ;
+    m_Planes[5] = rowW - rowZ;
+}
+
+void Frustum::cull(const BoxList& boxes, std::vector<uint8_t>& visible) const {
+    visible.assign(boxes.size(), 1);
+
+    for (const glm::vec4& plane : m_Planes) {
+        // The box corner furthest along the plane normal decides, so pick its arrays once per plane
+        const float* cornerX = plane.x >= 0.0f ? boxes.maxX.data() : boxes.minX.data();
+        const float* cornerY = plane.y >= 0.0f ? boxes.maxY.data() : boxes.minY.data();
+        const float* cornerZ = plane.z >= 0.0f ? boxes.maxZ.data() : boxes.minZ.data();
+        cullAgainstPlane(plane, cornerX, cornerY, cornerZ, visible.data(), boxes.size());
+    }
+}
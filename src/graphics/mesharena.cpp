@@ -0,0 +1,207 @@
+#include "graphics/mesharena.h"
+#include "world/chunksystem.h"
+#include <algorithm>
+#include <iterator>
+#include <glad/glad.h>
+
+namespace {
+
+const unsigned int QUAD_CORNER_ORDER[6] = {0, 1, 2, 2, 3, 0};
+
+// Rounding up leaves slack, so a rebuild that grows a little stays in place
+uint32_t roundUpToGranule(size_t vertices) {
+    const size_t granule = MeshArena::RANGE_GRANULE;
+    return (uint32_t)((vertices + granule - 1) / granule * granule);
+}
+
+size_t originBufferBytes(size_t vertices) {
+    return vertices / MeshArena::RANGE_GRANULE * sizeof(glm::ivec2);
+}
+
+} // namespace
+
+float MeshArenaStats::fragmentation() const {
+    size_t freeBytes = capacityBytes - allocatedBytes;
+    return freeBytes == 0 ? 0.0f : 1.0f - (float)largestFreeBytes / (float)freeBytes;
+}
+
+MeshArena::MeshArena(size_t initialVertices)
+    : m_CapacityVertices(roundUpToGranule(initialVertices)) {
+    addFreeRange(0, (uint32_t)m_CapacityVertices);
+}
+
+MeshArena::~MeshArena() {
+    if (m_VAO != 0) {
+        glDeleteVertexArrays(1, &m_VAO);
+        glDeleteBuffers(1, &m_VBO);
+        glDeleteBuffers(1, &m_EBO);
+        glDeleteBuffers(1, &m_OriginBuffer);
+        glDeleteTextures(1, &m_OriginTexture);
+    }
+}
+
+void MeshArena::createBuffers() {
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    glGenBuffers(1, &m_EBO);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferData(GL_ARRAY_BUFFER, m_CapacityVertices * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+
+    // Packed vertex attribute, read as an integer and unpacked in the vertex shader
+    glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    // Quad indices for the largest mesh a chunk can produce; the base vertex moves them onto each range
+    std::vector<unsigned int> indices;
+    indices.reserve(MAX_CHUNK_QUADS * 6);
+    for (unsigned int quad = 0; quad < (unsigned int)MAX_CHUNK_QUADS; ++quad) {
+        for (unsigned int corner : QUAD_CORNER_ORDER) {
+            indices.push_back(quad * 4 + corner);
+        }
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+
+    // One ivec2 origin per granule, read by the vertex shader through a buffer texture
+    glGenBuffers(1, &m_OriginBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, m_OriginBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, originBufferBytes(m_CapacityVertices), nullptr, GL_DYNAMIC_DRAW);
+    glGenTextures(1, &m_OriginTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, m_OriginTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32I, m_OriginBuffer);
+}
+
+void MeshArena::upload(MeshAllocation& allocation, const std::vector<uint32_t>& vertices, const glm::ivec2& origin) {
+    if (vertices.empty()) {
+        release(allocation);
+        return;
+    }
+    if (m_VAO == 0) {
+        createBuffers();
+    }
+
+    // Keep the range unless the mesh outgrew it or shrank to a fraction of it
+    uint32_t needed = roundUpToGranule(vertices.size());
+    if (allocation.vertexCapacity < needed || allocation.vertexCapacity > needed * 4) {
+        release(allocation);
+        if (!allocate(needed, allocation)) {
+            grow(m_CapacityVertices + needed);
+            allocate(needed, allocation);
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)allocation.firstVertex * sizeof(uint32_t), vertices.size() * sizeof(uint32_t), vertices.data());
+    writeOrigin(allocation, origin);
+}
+
+void MeshArena::writeOrigin(const MeshAllocation& allocation, const glm::ivec2& origin) {
+    std::vector<glm::ivec2> texels(allocation.vertexCapacity / RANGE_GRANULE, origin);
+    glBindBuffer(GL_TEXTURE_BUFFER, m_OriginBuffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, (GLintptr)originBufferBytes(allocation.firstVertex), texels.size() * sizeof(glm::ivec2), texels.data());
+}
+
+void MeshArena::release(MeshAllocation& allocation) {
+    if (allocation.vertexCapacity == 0) return;
+
+    m_AllocatedVertices -= allocation.vertexCapacity;
+    addFreeRange(allocation.firstVertex, allocation.vertexCapacity);
+    allocation = MeshAllocation{};
+}
+
+bool MeshArena::allocate(uint32_t vertices, MeshAllocation& allocation) {
+    // First fit, taking the front of the range and leaving the rest free
+    for (auto range = m_FreeRanges.begin(); range != m_FreeRanges.end(); ++range) {
+        auto [first, count] = *range;
+        if (count < vertices) continue;
+
+        m_FreeRanges.erase(range);
+        if (count > vertices) {
+            m_FreeRanges.emplace(first + vertices, count - vertices);
+        }
+        allocation = MeshAllocation{first, vertices};
+        m_AllocatedVertices += vertices;
+        return true;
+    }
+    return false;
+}
+
+void MeshArena::addFreeRange(uint32_t first, uint32_t count) {
+    auto next = m_FreeRanges.lower_bound(first);
+
+    // Merge with the free range that ends where this one starts
+    if (next != m_FreeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == first) {
+            first = previous->first;
+            count += previous->second;
+            m_FreeRanges.erase(previous);
+        }
+    }
+
+    // And with the one that starts where this one ends
+    if (next != m_FreeRanges.end() && first + count == next->first) {
+        count += next->second;
+        m_FreeRanges.erase(next);
+    }
+
+    m_FreeRanges.emplace(first, count);
+}
+
+void MeshArena::grow(size_t minimumVertices) {
+    size_t oldCapacity = m_CapacityVertices;
+    m_CapacityVertices = roundUpToGranule(std::max(oldCapacity * 2, minimumVertices));
+    m_GrowCount++;
+
+    // Copy every range into the larger buffer, so existing allocations stay valid
+    unsigned int grownVBO;
+    glGenBuffers(1, &grownVBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grownVBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, m_CapacityVertices * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_VBO);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldCapacity * sizeof(uint32_t));
+    glDeleteBuffers(1, &m_VBO);
+    m_VBO = grownVBO;
+
+    // Point the VAO at the new buffer
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+    glBindVertexArray(0);
+
+    // The origin buffer grows along with it
+    unsigned int grownOrigins;
+    glGenBuffers(1, &grownOrigins);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grownOrigins);
+    glBufferData(GL_COPY_WRITE_BUFFER, originBufferBytes(m_CapacityVertices), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_OriginBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, originBufferBytes(oldCapacity));
+    glDeleteBuffers(1, &m_OriginBuffer);
+    m_OriginBuffer = grownOrigins;
+    glBindTexture(GL_TEXTURE_BUFFER, m_OriginTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32I, m_OriginBuffer);
+
+    addFreeRange((uint32_t)oldCapacity, (uint32_t)(m_CapacityVertices - oldCapacity));
+}
+
+void MeshArena::bind(unsigned int originTextureUnit) const {
+    glBindVertexArray(m_VAO);
+    glActiveTexture(GL_TEXTURE0 + originTextureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_OriginTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+MeshArenaStats MeshArena::getStats() const {
+    MeshArenaStats stats;
+    stats.capacityBytes = m_CapacityVertices * sizeof(uint32_t);
+    stats.allocatedBytes = m_AllocatedVertices * sizeof(uint32_t);
+    stats.freeRanges = m_FreeRanges.size();
+    for (const auto& [first, count] : m_FreeRanges) {
+        stats.largestFreeBytes = std::max(stats.largestFreeBytes, (size_t)count * sizeof(uint32_t));
+    }
+    stats.growCount = m_GrowCount;
+    return stats;
+}
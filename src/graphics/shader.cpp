@@ -61,10 +61,47 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     // Delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    cacheUniformLocations();
+}
+
+void Shader::cacheUniformLocations() {
+    int uniformCount = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    for (int i = 0; i < uniformCount; ++i) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, i, sizeof(name), &length, &size, &type, name);
+
+        // Members of uniform blocks have no location and are set through their buffer
+        int location = glGetUniformLocation(ID, name);
+        if (location >= 0) {
+            m_UniformLocations.emplace(std::string(name, length), location);
+        }
+    }
+}
+
+int Shader::getUniformLocation(const std::string &name) const {
+    auto found = m_UniformLocations.find(name);
+    return found != m_UniformLocations.end() ? found->second : -1;
+}
+
+void Shader::bindUniformBlock(const char* blockName, unsigned int bindingPoint) const {
+    unsigned int blockIndex = glGetUniformBlockIndex(ID, blockName);
+    if (blockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(ID, blockIndex, bindingPoint);
+    }
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    setMat4(getUniformLocation(name), mat);
+}
+
+void Shader::setMat4(int location, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
 }
 
 void Shader::use() { 
@@ -90,7 +127,11 @@ void Shader::checkCompileErrors(unsigned int shader, std::string type) {
 }
 
 void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    setInt(getUniformLocation(name), value);
+}
+
+void Shader::setInt(int location, int value) const {
+    glUniform1i(location, value);
 }
 
 Shader::~Shader() {
@@ -0,0 +1,18 @@
+#include "graphics/uniformbuffer.h"
+#include <glad/glad.h>
+
+UniformBuffer::UniformBuffer(size_t size, unsigned int bindingPoint) {
+    glGenBuffers(1, &m_Buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_Buffer);
+}
+
+UniformBuffer::~UniformBuffer() {
+    glDeleteBuffers(1, &m_Buffer);
+}
+
+void UniformBuffer::update(const void* data, size_t size) {
+    glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+}
@@ -5,16 +5,25 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <chrono>
+#include <string>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "graphics/camera.h"
 #include "graphics/shader.h"
+#include "graphics/uniformbuffer.h"
+#include "ecs/components.h"
+#include "ecs/registry.h"
+#include "physics/physicssystem.h"
 #include "world/world.h"
 #include "world/raycast.h"
 #include "world/FastNoiseLite.h"
 
-Camera camera;
+// What the window callbacks act on, reached through the window user pointer
+struct InputTarget {
+    Registry* registry;
+    Entity player;
+};
 
 int main() {
     if (!glfwInit()) {
@@ -33,7 +42,16 @@ int main() {
         return -1;
     }
 
-    glfwSetWindowUserPointer(window, &camera);
+    // The player is an entity; its camera, motion and collision box are components
+    Registry registry;
+    Entity player = registry.create();
+    Transform& spawn = registry.emplace<Transform>(player, glm::vec3(8.0f, 68.0f, 8.0f));
+    registry.emplace<Velocity>(player);
+    registry.emplace<Collider>(player, AABB(spawn.position, glm::vec3(0.8f, 3.3f, 0.8f)));
+    registry.emplace<Camera>(player);
+
+    InputTarget inputTarget{&registry, player};
+    glfwSetWindowUserPointer(window, &inputTarget);
     glfwMakeContextCurrent(window);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -43,8 +61,8 @@ int main() {
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     auto mouseCallbackWrapper = [](GLFWwindow* window, double xpos, double ypos) {
-        Camera* camera = static_cast<Camera*>(glfwGetWindowUserPointer(window));
-        if (camera) {
+        InputTarget* target = static_cast<InputTarget*>(glfwGetWindowUserPointer(window));
+        if (Camera* camera = target ? target->registry->tryGet<Camera>(target->player) : nullptr) {
             camera->mouse_callback(xpos, ypos);
         }
     };
@@ -56,6 +74,17 @@ int main() {
     // Create the shader for the wireframe
     Shader wireframeShader("res/shaders/wireframe.vert", "res/shaders/wireframe.frag");
 
+    // Camera matrices live in one uniform buffer that both programs read
+    chunkShader.bindUniformBlock("Camera", CAMERA_UNIFORM_BINDING);
+    wireframeShader.bindUniformBlock("Camera", CAMERA_UNIFORM_BINDING);
+    UniformBuffer cameraUniforms(sizeof(CameraUniforms), CAMERA_UNIFORM_BINDING);
+    const int wireframeModelLocation = wireframeShader.getUniformLocation("model");
+
+    // The atlas always sits on texture unit 0
+    chunkShader.use();
+    chunkShader.setInt("texture_atlas", 0);
+    chunkShader.setInt("chunkOrigins", CHUNK_ORIGIN_TEXTURE_UNIT);
+
 
     glEnable(GL_DEPTH_TEST);
 
@@ -103,10 +132,11 @@ int main() {
     detailNoise.SetSeed(static_cast<int>(seed));
 
     // Calculate a safe spawn height to prevent player clipping on spawn
-    float noiseValue = noise.GetNoise(camera.cameraPos.x, camera.cameraPos.z);
-    float detailValue = detailNoise.GetNoise(camera.cameraPos.x, camera.cameraPos.z);
+    glm::vec3& spawnPosition = registry.get<Transform>(player).position;
+    float noiseValue = noise.GetNoise(spawnPosition.x, spawnPosition.z);
+    float detailValue = detailNoise.GetNoise(spawnPosition.x, spawnPosition.z);
     int groundHeight = 64 + (int)(noiseValue * 32.0f) + (int)(detailValue * 5.0f);
-    camera.cameraPos.y = groundHeight + 10.0f; // Add some positions for safety
+    spawnPosition.y = groundHeight + 10.0f; // Add some positions for safety
 
     World world(noise, detailNoise);
 
@@ -144,6 +174,7 @@ int main() {
 
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
+    float lastTitleUpdate = 0.0f;
 
     int x = 0;
     int y = 0;
@@ -154,35 +185,45 @@ int main() {
         lastFrame = currentFrame;
 
         // Input
-        camera.processInput(window, world, deltaTime);
-        camera.updatePosition(world, deltaTime);
+        registry.get<Camera>(player).processInput(window, world, registry, player, deltaTime);
 
         // Update
-        world.updateChunksAroundPlayer(camera.cameraPos);        
+        PhysicsSystem::update(registry, world, deltaTime);
+        const Camera& camera = registry.get<Camera>(player);
+        const glm::vec3& cameraPos = registry.get<Transform>(player).position;
+        world.updateChunksAroundPlayer(cameraPos, camera.cameraFront);
         world.update();
 
         // Render
         glClearColor(0.1f, 0.2f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // Set matrices that are the same for every program and chunk
+        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + camera.cameraFront, camera.cameraUp);
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 1000.0f);
+
+        CameraUniforms cameraData{view, projection};
+        cameraUniforms.update(&cameraData, sizeof(cameraData));
+
         chunkShader.use();
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, texture);
-        chunkShader.setInt("texture_atlas", 0);
 
-        // Set matrices that are the same for all chunks
-        glm::mat4 view = glm::lookAt(camera.cameraPos, camera.cameraPos + camera.cameraFront, camera.cameraUp);
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 1000.0f);
-        
-        chunkShader.setMat4("view", view);
-        chunkShader.setMat4("projection", projection);
+        world.render(projection * view);
 
-        world.render(chunkShader);
+        // Show how many chunks survive frustum culling and the draws they took, refreshed once a second
+        if (currentFrame - lastTitleUpdate >= 1.0f) {
+            lastTitleUpdate = currentFrame;
+            const World::RenderStats& stats = world.getRenderStats();
+            std::string title = "Minecraft window - " + std::to_string(stats.chunksDrawn) + " chunks drawn, " +
+                                std::to_string(stats.chunksCulled) + " culled, " + std::to_string(stats.drawCalls) + " draw calls";
+            glfwSetWindowTitle(window, title.c_str());
+        }
 
-        auto hit = RaycastSystem::cast(world, camera.cameraPos, camera.cameraFront, 5.0f);
+        auto hit = RaycastSystem::cast(world, cameraPos, camera.cameraFront, 5.0f);
         if (hit.has_value()) {
             wireframeShader.use();
 
@@ -197,10 +238,8 @@ int main() {
             // 4. Translate back
             model = glm::translate(model, glm::vec3(-0.5f));
 
-            // Set all the matrices for the wireframe shader
-            wireframeShader.setMat4("model", model);
-            wireframeShader.setMat4("view", view); // Use the same view matrix as the world
-            wireframeShader.setMat4("projection", projection); // Use the same projection matrix
+            // View and projection come from the camera uniform buffer
+            wireframeShader.setMat4(wireframeModelLocation, model);
 
             glLineWidth(3.0f);
 
@@ -1,8 +1,30 @@
 // src/physics/physicssystem.cpp
 #include "physics/physicssystem.h"
+#include "ecs/components.h"
 #include <algorithm>
 #include <cmath>
 
+namespace {
+
+// First block of the next cell along an axis divided into cells of `size` blocks
+int nextBoundary(int value, int size) {
+    return value - ((value % size) + size) % size + size;
+}
+
+// True when every block in the range lies in an all-air section, so per-block checks can be skipped
+bool isRegionEmpty(const World& world, int minX, int maxX, int minY, int maxY, int minZ, int maxZ) {
+    for (int x = minX; x < maxX; x = nextBoundary(x, CHUNK_WIDTH)) {
+        for (int y = minY; y < maxY; y = nextBoundary(y, SECTION_HEIGHT)) {
+            for (int z = minZ; z < maxZ; z = nextBoundary(z, CHUNK_DEPTH)) {
+                if (!world.isSectionEmpty(x, y, z)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 void PhysicsSystem::resolveCollision(World& world, AABB& entityAABB, glm::vec3& position, glm::vec3& velocity, bool& onGround, float deltaTime) {
     // A small buffer to prevent floating-point errors from causing sticking.
     const float SKIN_WIDTH = 0.005f;
@@ -17,23 +39,25 @@ void PhysicsSystem::resolveCollision(World& world, AABB& entityAABB, glm::vec3&
     int minX = floor(entityAABB.min.x), maxX = ceil(entityAABB.max.x);
     int minZ = floor(entityAABB.min.z), maxZ = ceil(entityAABB.max.z);
 
-    for (int y = minY; y < maxY; ++y) {
-    for (int x = minX; x < maxX; ++x) {
-    for (int z = minZ; z < maxZ; ++z) {
-        if (world.getBlock(x, y, z) != BlockID::Air) {
-            AABB blockAABB({x + 0.5f, y + 0.5f, z + 0.5f}, glm::vec3(1.0f));
-            if (entityAABB.intersects(blockAABB)) {
-                if (velocity.y > 0) { // Moving up
-                    position.y = blockAABB.min.y - entitySize.y / 2.0f - SKIN_WIDTH;
-                } else if (velocity.y < 0) { // Moving down
-                    position.y = blockAABB.max.y + entitySize.y / 2.0f + SKIN_WIDTH;
-                    onGround = true;
+    if (!isRegionEmpty(world, minX, maxX, minY, maxY, minZ, maxZ)) {
+        for (int y = minY; y < maxY; ++y) {
+        for (int x = minX; x < maxX; ++x) {
+        for (int z = minZ; z < maxZ; ++z) {
+            if (world.getBlock(x, y, z) != BlockID::Air) {
+                AABB blockAABB({x + 0.5f, y + 0.5f, z + 0.5f}, glm::vec3(1.0f));
+                if (entityAABB.intersects(blockAABB)) {
+                    if (velocity.y > 0) { // Moving up
+                        position.y = blockAABB.min.y - entitySize.y / 2.0f - SKIN_WIDTH;
+                    } else if (velocity.y < 0) { // Moving down
+                        position.y = blockAABB.max.y + entitySize.y / 2.0f + SKIN_WIDTH;
+                        onGround = true;
+                    }
+                    velocity.y = 0;
+                    entityAABB = AABB(position, entitySize);
                 }
-                velocity.y = 0;
-                entityAABB = AABB(position, entitySize);
             }
-        }
-    }}}
+        }}}
+    }
 
     // X-AXIS
     position.x += velocity.x * deltaTime;
@@ -42,22 +66,24 @@ void PhysicsSystem::resolveCollision(World& world, AABB& entityAABB, glm::vec3&
     minY = floor(entityAABB.min.y); maxY = ceil(entityAABB.max.y);
     minZ = floor(entityAABB.min.z); maxZ = ceil(entityAABB.max.z);
 
-    for (int y = minY; y < maxY; ++y) {
-    for (int x = minX; x < maxX; ++x) {
-    for (int z = minZ; z < maxZ; ++z) {
-        if (world.getBlock(x, y, z) != BlockID::Air) {
-            AABB blockAABB({x + 0.5f, y + 0.5f, z + 0.5f}, glm::vec3(1.0f));
-            if (entityAABB.intersects(blockAABB)) {
-                if (velocity.x > 0) { // Moving right
-                    position.x = blockAABB.min.x - entitySize.x / 2.0f - SKIN_WIDTH;
-                } else if (velocity.x < 0) { // Moving left
-                    position.x = blockAABB.max.x + entitySize.x / 2.0f + SKIN_WIDTH;
+    if (!isRegionEmpty(world, minX, maxX, minY, maxY, minZ, maxZ)) {
+        for (int y = minY; y < maxY; ++y) {
+        for (int x = minX; x < maxX; ++x) {
+        for (int z = minZ; z < maxZ; ++z) {
+            if (world.getBlock(x, y, z) != BlockID::Air) {
+                AABB blockAABB({x + 0.5f, y + 0.5f, z + 0.5f}, glm::vec3(1.0f));
+                if (entityAABB.intersects(blockAABB)) {
+                    if (velocity.x > 0) { // Moving right
+                        position.x = blockAABB.min.x - entitySize.x / 2.0f - SKIN_WIDTH;
+                    } else if (velocity.x < 0) { // Moving left
+                        position.x = blockAABB.max.x + entitySize.x / 2.0f + SKIN_WIDTH;
+                    }
+                    velocity.x = 0;
+                    entityAABB = AABB(position, entitySize);
                 }
-                velocity.x = 0;
-                entityAABB = AABB(position, entitySize);
             }
-        }
-    }}}
+        }}}
+    }
     
     // Z-AXIS
     position.z += velocity.z * deltaTime;
@@ -66,20 +92,30 @@ void PhysicsSystem::resolveCollision(World& world, AABB& entityAABB, glm::vec3&
     minX = floor(entityAABB.min.x); maxX = ceil(entityAABB.max.x);
     minY = floor(entityAABB.min.y); maxY = ceil(entityAABB.max.y);
 
-    for (int y = minY; y < maxY; ++y) {
-    for (int x = minX; x < maxX; ++x) {
-    for (int z = minZ; z < maxZ; ++z) {
-        if (world.getBlock(x, y, z) != BlockID::Air) {
-            AABB blockAABB({x + 0.5f, y + 0.5f, z + 0.5f}, glm::vec3(1.0f));
-            if (entityAABB.intersects(blockAABB)) {
-                if (velocity.z > 0) { // Moving forward
-                    position.z = blockAABB.min.z - entitySize.z / 2.0f - SKIN_WIDTH;
-                } else if (velocity.z < 0) { // Moving backward
-                    position.z = blockAABB.max.z + entitySize.z / 2.0f + SKIN_WIDTH;
+    if (!isRegionEmpty(world, minX, maxX, minY, maxY, minZ, maxZ)) {
+        for (int y = minY; y < maxY; ++y) {
+        for (int x = minX; x < maxX; ++x) {
+        for (int z = minZ; z < maxZ; ++z) {
+            if (world.getBlock(x, y, z) != BlockID::Air) {
+                AABB blockAABB({x + 0.5f, y + 0.5f, z + 0.5f}, glm::vec3(1.0f));
+                if (entityAABB.intersects(blockAABB)) {
+                    if (velocity.z > 0) { // Moving forward
+                        position.z = blockAABB.min.z - entitySize.z / 2.0f - SKIN_WIDTH;
+                    } else if (velocity.z < 0) { // Moving backward
+                        position.z = blockAABB.max.z + entitySize.z / 2.0f + SKIN_WIDTH;
+                    }
+                    velocity.z = 0;
+                    entityAABB = AABB(position, entitySize);
                 }
-                velocity.z = 0;
-                entityAABB = AABB(position, entitySize);
             }
-        }
-    }}}
-}
\ No newline at end of file
+        }}}
+    }
+}
+
+void PhysicsSystem::update(Registry& registry, World& world, float deltaTime) {
+    registry.view<Transform, Velocity, Collider>().each(
+        [&](Entity, Transform& transform, Velocity& velocity, Collider& collider) {
+            velocity.linear.y -= World::GRAVITY * deltaTime;
+            resolveCollision(world, collider.box, transform.position, velocity.linear, collider.onGround, deltaTime);
+        });
+}
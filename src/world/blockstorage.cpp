@@ -0,0 +1,126 @@
+#include "world/blockstorage.h"
+#include <array>
+
+namespace {
+    // Smallest index width in the 1, 2, 4, 8 progression that can address `entries` palette slots
+    int bitsFor(size_t entries) {
+        int bits = 1;
+        while (((size_t)1 << bits) < entries) {
+            bits *= 2;
+        }
+        return bits;
+    }
+}
+
+BlockStorage::BlockStorage(int size, BlockID fill, VoxelArena* arena)
+    : m_Size(size), m_Uniform(fill), m_Palette(VoxelAllocator<BlockID>(arena)), m_Data(VoxelAllocator<uint64_t>(arena)) {}
+
+void BlockStorage::set(int index, BlockID block) {
+    if (m_BitsPerEntry == 0) {
+        if (block == m_Uniform) {
+            return;
+        }
+        m_Palette.assign(1, m_Uniform);
+    }
+
+    int paletteIndex = paletteIndexOf(block);
+    int bit = index * m_BitsPerEntry;
+    uint64_t& word = m_Data[bit >> 6];
+    word &= ~(m_EntryMask << (bit & 63));
+    word |= (uint64_t)paletteIndex << (bit & 63);
+}
+
+void BlockStorage::fill(BlockID block) {
+    m_Uniform = block;
+    m_Palette.clear();
+    m_Data.clear();
+    m_BitsPerEntry = 0;
+    m_EntryMask = 0;
+}
+
+void BlockStorage::compact() {
+    if (m_BitsPerEntry == 0) {
+        return;
+    }
+
+    std::array<int, 256> uses{};
+    for (int i = 0; i < m_Size; ++i) {
+        int bit = i * m_BitsPerEntry;
+        uses[(m_Data[bit >> 6] >> (bit & 63)) & m_EntryMask]++;
+    }
+
+    std::array<uint8_t, 256> remap{};
+    std::array<BlockID, 256> palette;
+    size_t paletteSize = 0;
+    for (size_t i = 0; i < m_Palette.size(); ++i) {
+        if (uses[i] > 0) {
+            remap[i] = (uint8_t)paletteSize;
+            palette[paletteSize++] = m_Palette[i];
+        }
+    }
+
+    if (paletteSize == 1) {
+        fill(palette[0]);
+        return;
+    }
+    if (paletteSize == m_Palette.size()) {
+        return; // Every entry is still in use
+    }
+
+    resize(bitsFor(paletteSize), remap.data());
+    m_Palette.assign(palette.begin(), palette.begin() + paletteSize);
+}
+
+bool BlockStorage::isUniform() const {
+    return m_BitsPerEntry == 0;
+}
+
+int BlockStorage::bitsPerEntry() const {
+    return m_BitsPerEntry;
+}
+
+size_t BlockStorage::paletteSize() const {
+    return m_BitsPerEntry == 0 ? 1 : m_Palette.size();
+}
+
+size_t BlockStorage::memoryUsage() const {
+    return sizeof(BlockStorage) + m_Palette.size() * sizeof(BlockID) + m_Data.size() * sizeof(uint64_t);
+}
+
+int BlockStorage::paletteIndexOf(BlockID block) {
+    for (size_t i = 0; i < m_Palette.size(); ++i) {
+        if (m_Palette[i] == block) {
+            return (int)i;
+        }
+    }
+
+    m_Palette.push_back(block);
+    if (m_Palette.size() > (size_t)1 << m_BitsPerEntry) {
+        resize(bitsFor(m_Palette.size()));
+    }
+    return (int)m_Palette.size() - 1;
+}
+
+void BlockStorage::resize(int bitsPerEntry, const uint8_t* remap) {
+    // Entries are rewritten from a per-thread copy, so m_Data keeps its buffer. A storage that is filled
+    // and refilled, like one in a recycled chunk, then stops allocating once it has reached its largest width.
+    thread_local std::vector<uint64_t> previous;
+    previous.assign(m_Data.begin(), m_Data.end());
+    m_Data.assign(((size_t)m_Size * bitsPerEntry + 63) / 64, 0);
+
+    // Coming from a uniform storage every index is 0, which the zeroed array already holds
+    if (m_BitsPerEntry != 0) {
+        for (int i = 0; i < m_Size; ++i) {
+            int oldBit = i * m_BitsPerEntry;
+            uint64_t paletteIndex = (previous[oldBit >> 6] >> (oldBit & 63)) & m_EntryMask;
+            if (remap) {
+                paletteIndex = remap[paletteIndex];
+            }
+            int newBit = i * bitsPerEntry;
+            m_Data[newBit >> 6] |= paletteIndex << (newBit & 63);
+        }
+    }
+
+    m_BitsPerEntry = bitsPerEntry;
+    m_EntryMask = (1ull << bitsPerEntry) - 1;
+}
@@ -0,0 +1,161 @@
+#include "world/chunkmap.h"
+
+namespace {
+    const size_t MIN_CAPACITY = 1024; // Power of two
+}
+
+ChunkMap::ChunkMap(ChunkStorageMode mode, int ringSize, ChunkPool* pool) : m_Mode(mode), m_RingSize(1), m_Pool(pool) {
+    if (m_Mode == ChunkStorageMode::RingBuffer) {
+        // Round the side up to a power of two so wrapping a coordinate is a single mask
+        while (m_RingSize < ringSize) {
+            m_RingSize *= 2;
+        }
+        m_Mask = m_RingSize - 1;
+        m_Slots = std::vector<Slot>(m_RingSize * m_RingSize);
+    } else {
+        // Insert grows the table past half full, so leave room for a ringSize square of chunks at that load
+        size_t capacity = MIN_CAPACITY;
+        while (capacity < 2 * (size_t)ringSize * (size_t)ringSize) {
+            capacity *= 2;
+        }
+        m_Slots = std::vector<Slot>(capacity);
+        m_Mask = capacity - 1;
+    }
+}
+
+uint64_t ChunkMap::packCoord(const ChunkCoord& coord) {
+    return (uint64_t)(uint32_t)coord.x << 32 | (uint32_t)coord.y;
+}
+
+size_t ChunkMap::slotFor(uint64_t key) const {
+    // Fibonacci hashing spreads neighbouring coordinates over the whole table
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & m_Mask;
+}
+
+size_t ChunkMap::ringSlotFor(const ChunkCoord& coord) const {
+    // Masking the two's complement value wraps negative coordinates as well
+    return (size_t)(coord.x & (int)m_Mask) + (size_t)(coord.y & (int)m_Mask) * m_RingSize;
+}
+
+size_t ChunkMap::findSlot(const ChunkCoord& coord) const {
+    if (m_Mode == ChunkStorageMode::RingBuffer) {
+        size_t index = ringSlotFor(coord);
+        const Slot& slot = m_Slots[index];
+        return slot.occupied && slot.coord == coord ? index : m_Slots.size();
+    }
+
+    size_t index = slotFor(packCoord(coord));
+    while (m_Slots[index].occupied) {
+        if (m_Slots[index].coord == coord) {
+            return index;
+        }
+        index = (index + 1) & m_Mask;
+    }
+    return m_Slots.size(); // Not found
+}
+
+Chunk* ChunkMap::find(const ChunkCoord& coord) {
+    size_t index = findSlot(coord);
+    return index != m_Slots.size() ? m_Slots[index].chunk.get() : nullptr;
+}
+
+const Chunk* ChunkMap::find(const ChunkCoord& coord) const {
+    size_t index = findSlot(coord);
+    return index != m_Slots.size() ? m_Slots[index].chunk.get() : nullptr;
+}
+
+bool ChunkMap::contains(const ChunkCoord& coord) const {
+    return findSlot(coord) != m_Slots.size();
+}
+
+Chunk& ChunkMap::insert(const ChunkCoord& coord, PooledChunk chunk) {
+    if (m_Mode == ChunkStorageMode::RingBuffer) {
+        Slot& slot = m_Slots[ringSlotFor(coord)];
+        if (!slot.occupied) {
+            m_Size++;
+        }
+        slot.coord = coord;
+        slot.occupied = true;
+        slot.chunk = std::move(chunk);
+        return *slot.chunk;
+    }
+
+    // Keep the load factor at or below 1/2 so probe sequences stay short
+    if ((m_Size + 1) * 2 > m_Slots.size()) {
+        grow();
+    }
+
+    size_t index = slotFor(packCoord(coord));
+    while (m_Slots[index].occupied) {
+        if (m_Slots[index].coord == coord) {
+            m_Slots[index].chunk = std::move(chunk);
+            return *m_Slots[index].chunk;
+        }
+        index = (index + 1) & m_Mask;
+    }
+
+    m_Slots[index].coord = coord;
+    m_Slots[index].chunk = std::move(chunk);
+    m_Slots[index].occupied = true;
+    m_Size++;
+    return *m_Slots[index].chunk;
+}
+
+Chunk& ChunkMap::emplace(const ChunkCoord& coord) {
+    return insert(coord, m_Pool ? m_Pool->acquire() : PooledChunk(new Chunk()));
+}
+
+bool ChunkMap::erase(const ChunkCoord& coord) {
+    size_t index = findSlot(coord);
+    if (index == m_Slots.size()) {
+        return false;
+    }
+
+    m_Slots[index].occupied = false;
+    m_Slots[index].chunk.reset();
+    m_Size--;
+
+    if (m_Mode == ChunkStorageMode::RingBuffer) {
+        return true;
+    }
+
+    // Shift following entries back into the hole unless they already sit at or after their home slot
+    size_t hole = index;
+    size_t next = (index + 1) & m_Mask;
+    while (m_Slots[next].occupied) {
+        size_t home = slotFor(packCoord(m_Slots[next].coord));
+        if (((next - home) & m_Mask) >= ((next - hole) & m_Mask)) {
+            m_Slots[hole] = std::move(m_Slots[next]);
+            m_Slots[next].occupied = false;
+            hole = next;
+        }
+        next = (next + 1) & m_Mask;
+    }
+
+    return true;
+}
+
+size_t ChunkMap::size() const {
+    return m_Size;
+}
+
+void ChunkMap::clear() {
+    for (Slot& slot : m_Slots) {
+        slot.occupied = false;
+        slot.chunk.reset();
+    }
+    m_Size = 0;
+}
+
+void ChunkMap::grow() {
+    std::vector<Slot> old = std::move(m_Slots);
+    m_Slots = std::vector<Slot>(old.size() * 2);
+    m_Mask = m_Slots.size() - 1;
+    m_Size = 0;
+
+    for (Slot& slot : old) {
+        if (slot.occupied) {
+            insert(slot.coord, std::move(slot.chunk));
+        }
+    }
+}
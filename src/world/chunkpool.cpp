@@ -0,0 +1,74 @@
+#include "world/chunkpool.h"
+#include <new>
+
+namespace {
+    // Voxel memory budgeted per pooled chunk. Generated terrain keeps about 4 KiB of palettes and index arrays per
+    // chunk; the rest leaves room for edits and for the snapshot copies mesh jobs take
+    const size_t VOXEL_BYTES_PER_CHUNK = 16 * 1024;
+}
+
+void ChunkReleaser::operator()(Chunk* chunk) const {
+    if (pool) {
+        pool->release(chunk);
+    } else {
+        delete chunk;
+    }
+}
+
+ChunkPool::ChunkPool(size_t capacity, bool hugePages)
+    : m_VoxelArena(capacity * VOXEL_BYTES_PER_CHUNK, hugePages),
+      m_Region(capacity * sizeof(Chunk), hugePages),
+      m_Chunks(static_cast<Chunk*>(m_Region.data())),
+      m_Capacity(capacity) {
+    m_Free.reserve(m_Capacity);
+    for (size_t i = m_Capacity; i-- > 0;) {
+        m_Free.push_back(new (&m_Chunks[i]) Chunk(&m_VoxelArena));
+    }
+}
+
+ChunkPool::~ChunkPool() {
+    for (size_t i = 0; i < m_Capacity; ++i) {
+        m_Chunks[i].~Chunk();
+    }
+}
+
+PooledChunk ChunkPool::acquire() {
+    Chunk* chunk = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Free.empty()) {
+            chunk = m_Free.back();
+            m_Free.pop_back();
+        } else {
+            m_HeapChunks++;
+        }
+    }
+
+    if (!chunk) {
+        return PooledChunk(new Chunk(&m_VoxelArena), ChunkReleaser{this});
+    }
+    chunk->reset();
+    return PooledChunk(chunk, ChunkReleaser{this});
+}
+
+void ChunkPool::release(Chunk* chunk) {
+    if (!owns(chunk)) {
+        delete chunk;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_HeapChunks--;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Free.push_back(chunk);
+}
+
+ChunkPoolStats ChunkPool::getStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return {m_Capacity, m_Capacity - m_Free.size(), m_HeapChunks, m_Region.hugePages() && m_VoxelArena.hugePages(),
+            m_VoxelArena.getStats()};
+}
+
+bool ChunkPool::owns(const Chunk* chunk) const {
+    return chunk >= m_Chunks && chunk < m_Chunks + m_Capacity;
+}
@@ -1,35 +1,372 @@
 #include "world/chunksystem.h"
 #include "world/FastNoiseLite.h"
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <vector>
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
+namespace {
 
-glm::vec2 getTextureCoordinates(BlockID blockType, int face) {
-    const float ATLAS_STEP = 1.0f / 2.0f;
+// Face order used throughout the mesher: +Y, -Y, +X, -X, +Z, -Z
+const glm::ivec3 FACE_NORMALS[6] = {
+    { 0,  1,  0}, { 0, -1,  0},
+    { 1,  0,  0}, {-1,  0,  0},
+    { 0,  0,  1}, { 0,  0, -1},
+};
 
+// Axis the face is perpendicular to, and the axes its texture u and v run along
+const int FACE_AXIS[6] = {1, 1, 0, 0, 2, 2};
+const int FACE_UV_AXES[6][2] = {{0, 2}, {0, 2}, {2, 1}, {2, 1}, {0, 1}, {0, 1}};
+
+// Unit cube corner of each face corner. Faces are indexed as the triangles (0, 1, 2) and (2, 3, 0).
+const glm::ivec3 FACE_CORNERS[6][4] = {
+    {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}}, // +Y (Top)
+    {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}, // -Y (Bottom)
+    {{1, 0, 0}, {1, 1, 0}, {1, 1, 1}, {1, 0, 1}}, // +X (East)
+    {{0, 0, 0}, {0, 1, 0}, {0, 1, 1}, {0, 0, 1}}, // -X (West)
+    {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}, // +Z (South)
+    {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}}, // -Z (North)
+};
+
+// Returns the atlas tile (column + row * 2) used for a face of a block
+int getTextureTile(BlockID blockType, int face) {
     switch (blockType) {
         case BlockID::Grass:
-            if (face == 0) return {1.0f * ATLAS_STEP, 0.0f * ATLAS_STEP}; // Top face -> Grass Top (0, 1)
-            if (face == 1) return {0.0f * ATLAS_STEP, 0.0f * ATLAS_STEP}; // Bottom face -> Dirt (0, 0)
-            return {0.0f * ATLAS_STEP, 1.0f * ATLAS_STEP};              // Sides -> Grass Side (1, 0)
-        
+            if (face == 0) return 1; // Top face -> Grass Top (1, 0)
+            if (face == 1) return 0; // Bottom face -> Dirt (0, 0)
+            return 2;                // Sides -> Grass Side (0, 1)
+
         case BlockID::Dirt:
-            return {0.0f * ATLAS_STEP, 0.0f * ATLAS_STEP}; // All faces -> Dirt (0, 0)
+            return 0; // All faces -> Dirt (0, 0)
 
         case BlockID::Stone:
-            return {1.0f * ATLAS_STEP, 1.0f * ATLAS_STEP}; // All faces -> Stone (1, 1)
-        
+            return 3; // All faces -> Stone (1, 1)
+
         default:
-            return {0.0f, 0.0f};
+            return 0;
+    }
+}
+
+// Packs a local vertex position (0..16, 0..256, 0..16), face and atlas tile into 32 bits:
+// x in bits 0-4, y in 5-13, z in 14-18, face in 19-21 and tile in 22-29.
+// Texture coordinates are rebuilt from position and face in shader.vert.
+ChunkVertex packVertex(const glm::ivec3& position, int face, int tile) {
+    return (ChunkVertex)position.x
+         | (ChunkVertex)position.y << 5
+         | (ChunkVertex)position.z << 14
+         | (ChunkVertex)face << 19
+         | (ChunkVertex)tile << 22;
+}
+
+// Appends the four corners of a quad covering `size` blocks starting at `origin`
+void emitQuad(std::vector<ChunkVertex>& meshVertices, int face, const glm::ivec3& origin, const glm::ivec3& size, int tile) {
+    for (const glm::ivec3& corner : FACE_CORNERS[face]) {
+        meshVertices.push_back(packVertex(origin + corner * size, face, tile));
     }
 }
 
+// Block layers [begin, end) of a chunk
+struct LayerRange {
+    int begin;
+    int end;
+
+    // The range grown by the layer on either side, where they exist
+    LayerRange padded() const {
+        return {std::max(begin - 1, 0), std::min(end + 1, CHUNK_HEIGHT)};
+    }
+};
+
+// A chunk's blocks with a one-block border copied from its horizontal neighbours, so nothing past the copy
+// needs bounds checks or neighbour lookups. Laid out x-major then y then z like the chunk sections. The border above and below the
+// chunk, the corner columns and the sides of missing neighbours stay air.
+// Only the layers being meshed and the layer on either side of them are copied; the rest holds stale blocks.
+struct PaddedVolume {
+    static constexpr int SIZE_X = CHUNK_WIDTH + 2;
+    static constexpr int SIZE_Y = CHUNK_HEIGHT + 2;
+    static constexpr int SIZE_Z = CHUNK_DEPTH + 2;
+    static constexpr int STRIDE_Y = SIZE_Z;
+    static constexpr int STRIDE_X = SIZE_Y * SIZE_Z;
+
+    std::array<BlockID, SIZE_X * SIZE_Y * SIZE_Z> blocks;
+
+    // Index of a chunk-local position, which may lie one block outside the chunk
+    static int indexOf(int x, int y, int z) {
+        return (x + 1) * STRIDE_X + (y + 1) * STRIDE_Y + (z + 1);
+    }
+
+    void fill(const Chunk& chunk, const Chunk* posX, const Chunk* negX, const Chunk* posZ, const Chunk* negZ, const LayerRange& layers) {
+        // Clear the copied layers of every column, as the corners and missing neighbours are never written
+        LayerRange copied = layers.padded();
+        for (int x = -1; x <= CHUNK_WIDTH; ++x) {
+            std::fill(&blocks[indexOf(x, copied.begin, -1)], &blocks[indexOf(x, copied.end, -1)], BlockID::Air);
+        }
+        for (int section = copied.begin / SECTION_HEIGHT; section <= (copied.end - 1) / SECTION_HEIGHT; ++section) {
+            if (chunk.isSectionEmpty(section)) continue;
+
+            const BlockStorage& storage = chunk.sections[section];
+            int sectionBottom = section * SECTION_HEIGHT;
+            int yBegin = std::max(sectionBottom, copied.begin);
+            int yEnd = std::min(sectionBottom + SECTION_HEIGHT, copied.end);
+            for (int x = 0; x < CHUNK_WIDTH; ++x) {
+                for (int y = yBegin; y < yEnd; ++y) {
+                    BlockID* row = &blocks[indexOf(x, y, 0)];
+                    if (storage.isUniform()) {
+                        std::fill(row, row + CHUNK_DEPTH, storage.get(0));
+                        continue;
+                    }
+                    int first = (x * SECTION_HEIGHT + y - sectionBottom) * CHUNK_DEPTH;
+                    for (int z = 0; z < CHUNK_DEPTH; ++z) {
+                        row[z] = storage.get(first + z);
+                    }
+                }
+            }
+        }
+
+        for (int y = copied.begin; y < copied.end; ++y) {
+            for (int t = 0; t < CHUNK_WIDTH; ++t) {
+                if (negX) blocks[indexOf(-1, y, t)] = negX->getBlock(CHUNK_WIDTH - 1, y, t);
+                if (posX) blocks[indexOf(CHUNK_WIDTH, y, t)] = posX->getBlock(0, y, t);
+                if (negZ) blocks[indexOf(t, y, -1)] = negZ->getBlock(t, y, CHUNK_DEPTH - 1);
+                if (posZ) blocks[indexOf(t, y, CHUNK_DEPTH)] = posZ->getBlock(t, y, 0);
+            }
+        }
+    }
+};
+
+// Flags for the 256 blocks of a column, bit y % 64 of word y / 64
+using ColumnBits = std::array<uint64_t, CHUNK_HEIGHT / 64>;
+
+// Exposed faces of every column of a chunk, found 64 blocks at a time from solidity bitmasks: a face is
+// exposed where its block is solid and the block it looks at is not.
+struct ExposedFaces {
+    // Per face, then chunk-local x and z
+    ColumnBits columns[6][CHUNK_WIDTH][CHUNK_DEPTH];
+
+    // Only faces of blocks in `layers` are correct, given a volume filled for the same layers.
+    // Only the words holding those layers and the layer on either side are touched.
+    void build(const Chunk& chunk, const PaddedVolume& volume, const LayerRange& layers) {
+        LayerRange copied = layers.padded();
+        const int firstWord = copied.begin / 64;
+        const int lastWord = (copied.end - 1) / 64;
+
+        // Solid blocks of the padded volume's columns, indexed x + 1 and z + 1
+        for (auto& row : m_Solid) {
+            for (ColumnBits& column : row) {
+                std::fill(&column[firstWord], &column[lastWord] + 1, 0);
+            }
+        }
+        // Faces of an empty section see nothing but its own air, so its layers can stay clear on the border too
+        for (int y = copied.begin; y < copied.end; ++y) {
+            if (chunk.isSectionEmpty(y / SECTION_HEIGHT)) {
+                y += SECTION_HEIGHT - 1 - y % SECTION_HEIGHT;
+                continue;
+            }
+            for (int x = 0; x < PaddedVolume::SIZE_X; ++x) {
+                const BlockID* row = &volume.blocks[PaddedVolume::indexOf(x - 1, y, -1)];
+                for (int z = 0; z < PaddedVolume::SIZE_Z; ++z) {
+                    m_Solid[x][z][y >> 6] |= (uint64_t)(row[z] != BlockID::Air) << (y & 63);
+                }
+            }
+        }
+
+        for (int face = 0; face < 6; ++face) {
+            const glm::ivec3& normal = FACE_NORMALS[face];
+            for (int x = 0; x < CHUNK_WIDTH; ++x) {
+                for (int z = 0; z < CHUNK_DEPTH; ++z) {
+                    const ColumnBits& solid = m_Solid[x + 1][z + 1];
+                    const ColumnBits& beside = m_Solid[x + 1 + normal.x][z + 1 + normal.z];
+                    ColumnBits& exposed = columns[face][x][z];
+
+                    // Vertical faces look along their own column, shifted by one block with carries between words.
+                    // Nothing lies above the top or below the bottom of the chunk. A carry from a word outside the
+                    // copied ones only reaches layers outside `layers`.
+                    for (int word = firstWord; word <= lastWord; ++word) {
+                        uint64_t facing = beside[word];
+                        if (normal.y > 0) {
+                            facing = solid[word] >> 1 | (word + 1 < (int)solid.size() ? solid[word + 1] << 63 : 0);
+                        } else if (normal.y < 0) {
+                            facing = solid[word] << 1 | (word > 0 ? solid[word - 1] >> 63 : 0);
+                        }
+                        exposed[word] = solid[word] & ~facing;
+                    }
+                }
+            }
+        }
+    }
+
+    bool isExposed(int face, int x, int y, int z) const {
+        return (columns[face][x][z][y >> 6] >> (y & 63)) & 1;
+    }
+
+private:
+    ColumnBits m_Solid[PaddedVolume::SIZE_X][PaddedVolume::SIZE_Z];
+};
+
+// Scratch space for meshing, reused by every mesh built on a thread since it is too large to allocate per call,
+// see threadScratch
+struct MeshScratch {
+    PaddedVolume volume;
+    ExposedFaces faces;
+};
+
+// Calls `visit(y)` for every set bit of a column within `layers`, lowest first
+template <typename Visit>
+void forEachSetBit(const ColumnBits& column, const LayerRange& layers, Visit visit) {
+    for (int word = layers.begin / 64; word <= (layers.end - 1) / 64; ++word) {
+        uint64_t bits = column[word];
+        int low = layers.begin - word * 64;
+        int high = layers.end - word * 64;
+        if (low > 0) bits &= ~0ull << low;
+        if (high < 64) bits &= (1ull << high) - 1;
+
+        for (; bits != 0; bits &= bits - 1) {
+            visit(word * 64 + std::countr_zero(bits));
+        }
+    }
+}
+
+// One quad per exposed block face
+void buildNaiveMesh(const MeshScratch& scratch, const LayerRange& layers, std::vector<ChunkVertex>& meshVertices) {
+    for (int face = 0; face < 6; ++face) {
+        for (int x = 0; x < CHUNK_WIDTH; ++x) {
+            for (int z = 0; z < CHUNK_DEPTH; ++z) {
+                forEachSetBit(scratch.faces.columns[face][x][z], layers, [&](int y) {
+                    BlockID block = scratch.volume.blocks[PaddedVolume::indexOf(x, y, z)];
+                    emitQuad(meshVertices, face, {x, y, z}, glm::ivec3(1), getTextureTile(block, face));
+                });
+            }
+        }
+    }
+}
+
+// Merges exposed faces that share a plane and an atlas tile into maximal rectangles.
+// Each slice along a face's axis is reduced to a 2D mask of tiles, which is then
+// consumed greedily: grow a run along u, then extend it along v while every row matches.
+// Quads stay within `layers`.
+void buildGreedyMesh(const Chunk& chunk, const MeshScratch& scratch, const LayerRange& layers, std::vector<ChunkVertex>& meshVertices) {
+    const int dims[3] = {CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_DEPTH};
+    // Large enough for any face's slices. Merging clears every cell it consumes, so it is only zeroed here
+    std::vector<int> mask(CHUNK_WIDTH * CHUNK_HEIGHT, 0);
+
+    for (int face = 0; face < 6; ++face) {
+        const int d = FACE_AXIS[face];
+        const int u = FACE_UV_AXES[face][0];
+        const int v = FACE_UV_AXES[face][1];
+        const int sliceBegin = d == 1 ? layers.begin : 0;
+        const int sliceEnd = d == 1 ? layers.end : dims[d];
+        const int rowBegin = v == 1 ? layers.begin : 0;
+        const int rowEnd = v == 1 ? layers.end : dims[v];
+
+        bool anyExposed = false;
+        auto markExposed = [&](int x, int y, int z, int cell) {
+            BlockID block = scratch.volume.blocks[PaddedVolume::indexOf(x, y, z)];
+            mask[cell] = getTextureTile(block, face) + 1;
+            anyExposed = true;
+        };
+
+        for (int slice = sliceBegin; slice < sliceEnd; ++slice) {
+            // Mask holds tile + 1 for every exposed face in this slice, 0 otherwise
+            anyExposed = false;
+            if (d == 1) {
+                if (chunk.isSectionEmpty(slice / SECTION_HEIGHT)) continue;
+
+                for (int z = 0; z < CHUNK_DEPTH; ++z) {
+                    for (int x = 0; x < CHUNK_WIDTH; ++x) {
+                        if (scratch.faces.isExposed(face, x, slice, z)) markExposed(x, slice, z, x + z * dims[u]);
+                    }
+                }
+            } else {
+                // Side faces of a slice are whole columns, with u across them and v along y
+                for (int i = 0; i < dims[u]; ++i) {
+                    int x = d == 0 ? slice : i;
+                    int z = d == 0 ? i : slice;
+                    forEachSetBit(scratch.faces.columns[face][x][z], layers, [&](int y) { markExposed(x, y, z, i + y * dims[u]); });
+                }
+            }
+
+            // Buried or open slices are common, and leave nothing to merge
+            if (!anyExposed) continue;
+
+            for (int j = rowBegin; j < rowEnd; ++j) {
+                if (v == 1 && chunk.isSectionEmpty(j / SECTION_HEIGHT)) {
+                    j += SECTION_HEIGHT - 1 - j % SECTION_HEIGHT; // Rows of an empty section are all clear
+                    continue;
+                }
+
+                for (int i = 0; i < dims[u];) {
+                    int key = mask[i + j * dims[u]];
+                    if (key == 0) {
+                        ++i;
+                        continue;
+                    }
+
+                    int width = 1;
+                    while (i + width < dims[u] && mask[i + width + j * dims[u]] == key) {
+                        ++width;
+                    }
+
+                    int height = 1;
+                    for (; j + height < rowEnd; ++height) {
+                        bool rowMatches = true;
+                        for (int k = 0; k < width; ++k) {
+                            if (mask[i + k + (j + height) * dims[u]] != key) {
+                                rowMatches = false;
+                                break;
+                            }
+                        }
+                        if (!rowMatches) break;
+                    }
+
+                    for (int h = 0; h < height; ++h) {
+                        for (int k = 0; k < width; ++k) {
+                            mask[i + k + (j + h) * dims[u]] = 0;
+                        }
+                    }
+
+                    glm::ivec3 origin;
+                    origin[d] = slice;
+                    origin[u] = i;
+                    origin[v] = j;
+
+                    glm::ivec3 size(1);
+                    size[u] = width;
+                    size[v] = height;
+
+                    emitQuad(meshVertices, face, origin, size, key - 1);
+                    i += width;
+                }
+            }
+        }
+    }
+}
+
+// Scratch space of the calling thread
+MeshScratch& threadScratch() {
+    thread_local MeshScratch scratch;
+    return scratch;
+}
+
+bool hasBlockInLayer(const Chunk& chunk, int y) {
+    for (int x = 0; x < CHUNK_WIDTH; ++x) {
+        for (int z = 0; z < CHUNK_DEPTH; ++z) {
+            if (chunk.getBlock(x, y, z) != BlockID::Air) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
 void ChunkSystem::generate(Chunk &chunk, int chunkX, int chunkZ, FastNoiseLite& noise, FastNoiseLite& detailNoise) {
 
     int worldStartX = chunkX * CHUNK_WIDTH;
     int worldStartZ = chunkZ * CHUNK_DEPTH;
 
+    for (BlockStorage& section : chunk.sections) {
+        section.fill(BlockID::Air);
+    }
+
      for (int x = 0; x < CHUNK_WIDTH; ++x) {
         for (int z = 0; z < CHUNK_DEPTH; ++z) {
             // Get the world coordinates for this block column
@@ -46,166 +383,150 @@ void ChunkSystem::generate(Chunk &chunk, int chunkX, int chunkZ, FastNoiseLite&
             int detailAmplitude = 5.0f;
             int groundHeight = 64 + (int)(noiseValue * baseAmplitude) + (int)(detailValue * detailAmplitude);
 
-            for (int y = 0; y < CHUNK_HEIGHT; ++y) {
+            // Everything above the grass stays air
+            for (int y = 0; y <= groundHeight && y < CHUNK_HEIGHT; ++y) {
                 if (y < groundHeight - 3) {
-                    chunk.blocks[x][y][z] = BlockID::Stone;
+                    chunk.setBlock(x, y, z, BlockID::Stone);
                 } else if (y < groundHeight) {
-                    chunk.blocks[x][y][z] = BlockID::Dirt;
-                } else if (y == groundHeight) {
-                    chunk.blocks[x][y][z] = BlockID::Grass;
+                    chunk.setBlock(x, y, z, BlockID::Dirt);
                 } else {
-                    chunk.blocks[x][y][z] = BlockID::Air;
+                    chunk.setBlock(x, y, z, BlockID::Grass);
                 }
             }
         }
     }
-}
 
-void ChunkSystem::buildMesh(Chunk &chunk, Chunk* neighbor_posX, Chunk* neighbor_negX, Chunk* neighbor_posZ, Chunk* neighbor_negZ) {
-    if (chunk.VBO != 0) {
-        glDeleteBuffers(1, &chunk.VBO);
-    }
-    if (chunk.VAO != 0) {
-        glDeleteVertexArrays(1, &chunk.VAO);
+    // Sections below the terrain end up all stone, collapse them to a single value
+    for (BlockStorage& section : chunk.sections) {
+        section.compact();
     }
 
-    std::vector<float> meshVertices;
-    const float ATLAS_STEP = 1.0f / 2.0f;
+    updateHeightBounds(chunk);
+    updateBorderMasks(chunk);
+}
 
-    for (int x = 0; x < CHUNK_WIDTH; ++x) {
-        for (int z = 0; z < CHUNK_DEPTH; ++z) {
-            for (int y = 0; y < CHUNK_HEIGHT; ++y) {
-                BlockID currentBlock = chunk.blocks[x][y][z];
-                if (currentBlock == BlockID::Air) continue;
-
-                // Helper lambda to check if a block is solid (not Air)
-                auto isBlockSolid = [&](int bx, int by, int bz) {
-                    // Check within the current chunk
-                    if (bx >= 0 && bx < CHUNK_WIDTH && by >= 0 && by < CHUNK_HEIGHT && bz >= 0 && bz < CHUNK_DEPTH) {
-                        return chunk.blocks[bx][by][bz] != BlockID::Air;
-                    }
-                    // Check neighbor chunks
-                    if (by < 0 || by >= CHUNK_HEIGHT) return false; // Out of vertical bounds
-
-                    if (bx < 0) return neighbor_negX && neighbor_negX->blocks[CHUNK_WIDTH + bx][by][bz] != BlockID::Air;
-                    if (bx >= CHUNK_WIDTH) return neighbor_posX && neighbor_posX->blocks[bx - CHUNK_WIDTH][by][bz] != BlockID::Air;
-                    if (bz < 0) return neighbor_negZ && neighbor_negZ->blocks[bx][by][CHUNK_DEPTH + bz] != BlockID::Air;
-                    if (bz >= CHUNK_DEPTH) return neighbor_posZ && neighbor_posZ->blocks[bx][by][bz - CHUNK_DEPTH] != BlockID::Air;
-                    
-                    return false; // Should not be reached
-                };
-
-                // Check face +Y (Top)
-                if (!isBlockSolid(x, y + 1, z)) {
-                    glm::vec2 uv = getTextureCoordinates(currentBlock, 0);
-                    // Add vertices for top face...
-                    meshVertices.insert(meshVertices.end(), {
-                        (float)x,     (float)y + 1, (float)z,     uv.x,            uv.y + ATLAS_STEP,
-                        (float)x,     (float)y + 1, (float)z + 1, uv.x,            uv.y,
-                        (float)x + 1, (float)y + 1, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x + 1, (float)y + 1, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x + 1, (float)y + 1, (float)z,     uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                        (float)x,     (float)y + 1, (float)z,     uv.x,            uv.y + ATLAS_STEP,
-                    });
-                }
-                // Check face -Y (Bottom)
-                if (!isBlockSolid(x, y - 1, z)) {
-                    glm::vec2 uv = getTextureCoordinates(currentBlock, 1);
-                    // Add vertices for bottom face...
-                     meshVertices.insert(meshVertices.end(), {
-                        (float)x,     (float)y, (float)z,     uv.x,            uv.y + ATLAS_STEP,
-                        (float)x + 1, (float)y, (float)z,     uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                        (float)x + 1, (float)y, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x + 1, (float)y, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x,     (float)y, (float)z + 1, uv.x,            uv.y,
-                        (float)x,     (float)y, (float)z,     uv.x,            uv.y + ATLAS_STEP,
-                    });
-                }
-                // Check face +X (East)
-                if (!isBlockSolid(x + 1, y, z)) {
-                    glm::vec2 uv = getTextureCoordinates(currentBlock, 2);
-                    // Add vertices for +X face...
-                    meshVertices.insert(meshVertices.end(), {
-                        (float)x + 1, (float)y,     (float)z,     uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                        (float)x + 1, (float)y + 1, (float)z,     uv.x + ATLAS_STEP, uv.y,
-                        (float)x + 1, (float)y + 1, (float)z + 1, uv.x,            uv.y,
-                        (float)x + 1, (float)y + 1, (float)z + 1, uv.x,            uv.y,
-                        (float)x + 1, (float)y,     (float)z + 1, uv.x,            uv.y + ATLAS_STEP,
-                        (float)x + 1, (float)y,     (float)z,     uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                    });
-                }
-                // Check face -X (West)
-                if (!isBlockSolid(x - 1, y, z)) {
-                    glm::vec2 uv = getTextureCoordinates(currentBlock, 3);
-                    // Add vertices for -X face...
-                     meshVertices.insert(meshVertices.end(), {
-                        (float)x, (float)y,     (float)z,     uv.x,            uv.y + ATLAS_STEP,
-                        (float)x, (float)y + 1, (float)z,     uv.x,            uv.y,
-                        (float)x, (float)y + 1, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x, (float)y + 1, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x, (float)y,     (float)z + 1, uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                        (float)x, (float)y,     (float)z,     uv.x,            uv.y + ATLAS_STEP,
-                    });
-                }
-                // Check face +Z (South)
-                if (!isBlockSolid(x, y, z + 1)) {
-                    glm::vec2 uv = getTextureCoordinates(currentBlock, 4);
-                    // Add vertices for +Z face...
-                     meshVertices.insert(meshVertices.end(), {
-                        (float)x,     (float)y,     (float)z + 1, uv.x,            uv.y + ATLAS_STEP,
-                        (float)x + 1, (float)y,     (float)z + 1, uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                        (float)x + 1, (float)y + 1, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x + 1, (float)y + 1, (float)z + 1, uv.x + ATLAS_STEP, uv.y,
-                        (float)x,     (float)y + 1, (float)z + 1, uv.x,            uv.y,
-                        (float)x,     (float)y,     (float)z + 1, uv.x,            uv.y + ATLAS_STEP,
-                    });
-                }
-                // Check face -Z (North)
-                if (!isBlockSolid(x, y, z - 1)) {
-                    glm::vec2 uv = getTextureCoordinates(currentBlock, 5);
-                    // Add vertices for -Z face...
-                     meshVertices.insert(meshVertices.end(), {
-                        (float)x,     (float)y,     (float)z, uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                        (float)x,     (float)y + 1, (float)z, uv.x + ATLAS_STEP, uv.y,
-                        (float)x + 1, (float)y + 1, (float)z, uv.x,            uv.y,
-                        (float)x + 1, (float)y + 1, (float)z, uv.x,            uv.y,
-                        (float)x + 1, (float)y,     (float)z, uv.x,            uv.y + ATLAS_STEP,
-                        (float)x,     (float)y,     (float)z, uv.x + ATLAS_STEP, uv.y + ATLAS_STEP,
-                    });
-                }
+void ChunkSystem::updateHeightBounds(Chunk& chunk) {
+    int lowest = CHUNK_HEIGHT;
+    int highest = -1;
+
+    for (int section = 0; section < SECTION_COUNT; ++section) {
+        if (chunk.isSectionEmpty(section)) continue;
+
+        int sectionBottom = section * SECTION_HEIGHT;
+        if (chunk.sections[section].isUniform()) {
+            lowest = std::min(lowest, sectionBottom);
+            highest = sectionBottom + SECTION_HEIGHT - 1;
+            continue;
+        }
+
+        for (int y = sectionBottom; y < sectionBottom + SECTION_HEIGHT; ++y) {
+            if (hasBlockInLayer(chunk, y)) {
+                lowest = std::min(lowest, y);
+                highest = y;
             }
         }
     }
 
-    chunk.vertexCount = meshVertices.size() / 5;
+    chunk.minHeight = highest < 0 ? 0 : lowest;
+    chunk.maxHeight = highest + 1;
+}
 
-    glGenVertexArrays(1, &chunk.VAO);
-    glGenBuffers(1, &chunk.VBO);
+void ChunkSystem::updateBorderMasks(Chunk& chunk) {
+    for (BorderMask& mask : chunk.borderMasks) {
+        mask.fill(0);
+    }
 
-    glBindVertexArray(chunk.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+    for (int y = chunk.minHeight; y < chunk.maxHeight; ++y) {
+        for (int t = 0; t < CHUNK_WIDTH; ++t) {
+            uint16_t bit = (uint16_t)(1u << t);
+            if (chunk.getBlock(CHUNK_WIDTH - 1, y, t) != BlockID::Air) chunk.borderMasks[NEIGHBOUR_POS_X][y] |= bit;
+            if (chunk.getBlock(0, y, t) != BlockID::Air) chunk.borderMasks[NEIGHBOUR_NEG_X][y] |= bit;
+            if (chunk.getBlock(t, y, CHUNK_DEPTH - 1) != BlockID::Air) chunk.borderMasks[NEIGHBOUR_POS_Z][y] |= bit;
+            if (chunk.getBlock(t, y, 0) != BlockID::Air) chunk.borderMasks[NEIGHBOUR_NEG_Z][y] |= bit;
+        }
+    }
+}
 
-    // Upload data to the VBO
-    glBufferData(GL_ARRAY_BUFFER, meshVertices.size() * sizeof(float), meshVertices.data(), GL_STATIC_DRAW);
+bool ChunkSystem::borderContactsChanged(const Chunk& chunk, int side, int section, const Chunk* neighbour) {
+    const BorderMask& own = chunk.borderMasks[side];
+    const BorderMask& meshed = chunk.meshedBorderContacts[side];
+    for (int y = section * SECTION_HEIGHT; y < (section + 1) * SECTION_HEIGHT; ++y) {
+        uint16_t row = neighbour ? own[y] & neighbour->borderMasks[side ^ 1][y] : 0;
+        if (row != meshed[y]) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+void ChunkSystem::recordBorderContacts(Chunk& chunk, int section) {
+    for (int side = 0; side < NEIGHBOUR_COUNT; ++side) {
+        const Chunk* neighbour = chunk.neighbours[side];
+        for (int y = section * SECTION_HEIGHT; y < (section + 1) * SECTION_HEIGHT; ++y) {
+            chunk.meshedBorderContacts[side][y] = neighbour ? chunk.borderMasks[side][y] & neighbour->borderMasks[side ^ 1][y] : 0;
+        }
+    }
+}
+
+std::vector<ChunkVertex> ChunkSystem::buildMeshData(const Chunk &chunk, const Chunk* neighbor_posX, const Chunk* neighbor_negX, const Chunk* neighbor_posZ, const Chunk* neighbor_negZ, MeshingMode mode) {
+    std::vector<ChunkVertex> meshVertices;
+    LayerRange layers{0, CHUNK_HEIGHT};
 
-    // Color attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    MeshScratch& scratch = threadScratch();
+    scratch.volume.fill(chunk, neighbor_posX, neighbor_negX, neighbor_posZ, neighbor_negZ, layers);
+    scratch.faces.build(chunk, scratch.volume, layers);
 
-    chunk.isDirty = false;
+    if (mode == MeshingMode::Greedy) {
+        buildGreedyMesh(chunk, scratch, layers, meshVertices);
+    } else {
+        buildNaiveMesh(scratch, layers, meshVertices);
+    }
+
+    return meshVertices;
 }
 
-void ChunkSystem::unloadMesh(Chunk &chunk) {
-    if (chunk.VBO != 0) {
-        glDeleteBuffers(1, &chunk.VBO);
-        chunk.VBO = 0;
+SectionMeshData ChunkSystem::buildSectionMeshData(const Chunk& chunk, const Chunk* neighbourPosX, const Chunk* neighbourNegX, const Chunk* neighbourPosZ, const Chunk* neighbourNegZ, uint16_t sections, MeshingMode mode) {
+    SectionMeshData meshes;
+    if (sections == 0) {
+        return meshes;
     }
-    if (chunk.VAO != 0) {
-        glDeleteVertexArrays(1, &chunk.VAO);
-        chunk.VAO = 0;
+
+    // One copy covers every requested section, from the lowest to the highest
+    int lowest = std::countr_zero(sections);
+    int highest = SECTION_COUNT - 1 - std::countl_zero(sections);
+    LayerRange copied{lowest * SECTION_HEIGHT, (highest + 1) * SECTION_HEIGHT};
+
+    MeshScratch& scratch = threadScratch();
+    scratch.volume.fill(chunk, neighbourPosX, neighbourNegX, neighbourPosZ, neighbourNegZ, copied);
+    scratch.faces.build(chunk, scratch.volume, copied);
+
+    for (int section = lowest; section <= highest; ++section) {
+        if (!(sections & (1u << section)) || chunk.isSectionEmpty(section)) continue;
+
+        LayerRange layers{section * SECTION_HEIGHT, (section + 1) * SECTION_HEIGHT};
+        if (mode == MeshingMode::Greedy) {
+            buildGreedyMesh(chunk, scratch, layers, meshes[section]);
+        } else {
+            buildNaiveMesh(scratch, layers, meshes[section]);
+        }
     }
-}
\ No newline at end of file
+
+    return meshes;
+}
+
+void ChunkSystem::uploadMesh(MeshArena& arena, Chunk &chunk, int section, int chunkX, int chunkZ, const std::vector<ChunkVertex>& meshVertices) {
+    // The vertex shader offsets every vertex by its range's origin
+    SectionMesh& mesh = chunk.meshes[section];
+    arena.upload(mesh.allocation, meshVertices, glm::ivec2(chunkX * CHUNK_WIDTH, chunkZ * CHUNK_DEPTH));
+
+    mesh.vertexCount = meshVertices.size();
+    mesh.indexCount = meshVertices.size() / 4 * 6;
+}
+
+void ChunkSystem::unloadMesh(MeshArena& arena, Chunk &chunk) {
+    for (SectionMesh& mesh : chunk.meshes) {
+        arena.release(mesh.allocation);
+        mesh.vertexCount = 0;
+        mesh.indexCount = 0;
+    }
+}
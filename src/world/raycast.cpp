@@ -1,33 +1,199 @@
 // src/world/raycast.cpp
 #include "world/raycast.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
 
-namespace RaycastSystem {
+namespace {
 
-std::optional<RaycastResult> cast(const World& world, const glm::vec3& origin, const glm::vec3& direction, float maxDistance) {
+int floorDiv(int value, int divisor) {
+    return (value >= 0 ? value : value - divisor + 1) / divisor;
+}
+
+glm::ivec3 sectionOf(const glm::ivec3& block) {
+    return {floorDiv(block.x, CHUNK_WIDTH), floorDiv(block.y, SECTION_HEIGHT), floorDiv(block.z, CHUNK_DEPTH)};
+}
+
+// Advances the traversal to the last voxel it visits inside the current section, without visiting the ones in between
+void skipSection(glm::ivec3& block, const glm::ivec3& step, glm::vec3& tMax, const glm::vec3& tDelta) {
+    const glm::ivec3 sectionSize(CHUNK_WIDTH, SECTION_HEIGHT, CHUNK_DEPTH);
+    glm::ivec3 sectionMin = sectionOf(block) * sectionSize;
+
+    // Whole voxels left before each axis leaves the section, and where the ray leaves it first
+    glm::ivec3 voxelsToEdge(0);
+    float tExit = std::numeric_limits<float>::infinity();
+    for (int axis = 0; axis < 3; ++axis) {
+        if (step[axis] == 0) continue;
+        voxelsToEdge[axis] = step[axis] > 0 ? sectionMin[axis] + sectionSize[axis] - 1 - block[axis] : block[axis] - sectionMin[axis];
+        tExit = std::min(tExit, tMax[axis] + voxelsToEdge[axis] * tDelta[axis]);
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        if (step[axis] == 0 || tMax[axis] >= tExit) continue;
+        int crossings = std::min(voxelsToEdge[axis], (int)std::ceil((tExit - tMax[axis]) / tDelta[axis]));
+        block[axis] += step[axis] * crossings;
+        tMax[axis] += tDelta[axis] * crossings;
+    }
+}
+
+// Remembers the last chunk looked up, so consecutive lookups in one chunk skip the chunk map
+struct ChunkCursor {
+    const World& world;
+    ChunkCoord coord{std::numeric_limits<int>::min(), 0};
+    const Chunk* chunk = nullptr;
+
+    const Chunk* at(const glm::ivec3& section) {
+        ChunkCoord sectionChunk(section.x, section.z);
+        if (sectionChunk != coord) {
+            coord = sectionChunk;
+            chunk = world.getChunk(coord);
+        }
+        return chunk;
+    }
+};
+
+// Shared between the threads working on one castBatch call
+struct BatchState {
+    std::vector<uint32_t> order; // Ray indices sorted by starting chunk
+    size_t groupCount = 0;
+    std::atomic<size_t> nextGroup = 0;
+    std::atomic<size_t> finishedGroups = 0;
+    std::mutex mutex;
+    std::condition_variable done;
+};
+
+// Rays handed out to a thread at a time
+const size_t RAYS_PER_GROUP = 64;
+
+bool isSectionEmpty(const Chunk* chunk, const glm::ivec3& section) {
+    return section.y < 0 || section.y >= SECTION_COUNT || !chunk || chunk->isSectionEmpty(section.y);
+}
+
+// Amanatides-Woo grid traversal: steps from voxel to voxel across whichever boundary the ray reaches first,
+// so every voxel the ray touches is visited exactly once
+std::optional<RaycastResult> traverse(ChunkCursor& cursor, const glm::vec3& origin, const glm::vec3& direction, float maxDistance) {
     if (glm::length(direction) == 0.0f) {
         return std::nullopt;
     }
 
-    glm::vec3 step = glm::normalize(direction) * 0.2f;
-    glm::vec3 currentPos = origin;
-    glm::ivec3 lastBlockPos = {floor(origin.x), floor(origin.y), floor(origin.z)};
+    const float INF = std::numeric_limits<float>::infinity();
+    glm::vec3 unitDirection = glm::normalize(direction);
+    glm::ivec3 block = glm::ivec3(glm::floor(origin));
+    glm::ivec3 step(0);
+    glm::vec3 tMax(INF);   // Distance along the ray to the next boundary on each axis
+    glm::vec3 tDelta(INF); // Distance along the ray between two boundaries on each axis
+
+    for (int axis = 0; axis < 3; ++axis) {
+        if (unitDirection[axis] > 0.0f) {
+            step[axis] = 1;
+            tDelta[axis] = 1.0f / unitDirection[axis];
+            tMax[axis] = (block[axis] + 1.0f - origin[axis]) * tDelta[axis];
+        } else if (unitDirection[axis] < 0.0f) {
+            step[axis] = -1;
+            tDelta[axis] = -1.0f / unitDirection[axis];
+            tMax[axis] = (origin[axis] - block[axis]) * tDelta[axis];
+        }
+    }
 
-    for (float traveled = 0.0f; traveled < maxDistance; traveled += 0.2f) {
-        currentPos += step;
-        glm::ivec3 currentBlockPos = {floor(currentPos.x), floor(currentPos.y), floor(currentPos.z)};
+    glm::ivec3 section = sectionOf(block);
+    const Chunk* chunk = cursor.at(section);
+    bool sectionEmpty = isSectionEmpty(chunk, section);
 
-        // Check if we've entered a new block
-        if (currentBlockPos != lastBlockPos) {
-            if (world.getBlock(currentBlockPos.x, currentBlockPos.y, currentBlockPos.z) != BlockID::Air) {
-                // We hit a solid block
-                return RaycastResult{currentBlockPos, lastBlockPos};
+    // The block containing the origin is never reported, as before
+    while (true) {
+        int axis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+        float distance = tMax[axis];
+        if (distance > maxDistance) {
+            return std::nullopt;
+        }
+
+        block[axis] += step[axis];
+        tMax[axis] += tDelta[axis];
+
+        // Nothing above or below the world can be hit once the ray leaves it vertically
+        if ((block.y >= CHUNK_HEIGHT && step.y >= 0) || (block.y < 0 && step.y <= 0)) {
+            return std::nullopt;
+        }
+
+        // Only ask the world about a section once, and jump across all-air ones
+        glm::ivec3 blockSection = sectionOf(block);
+        if (blockSection != section) {
+            section = blockSection;
+            chunk = cursor.at(section);
+            sectionEmpty = isSectionEmpty(chunk, section);
+        }
+        if (sectionEmpty) {
+            skipSection(block, step, tMax, tDelta);
+            continue;
+        }
+
+        if (chunk->getBlock(block.x - section.x * CHUNK_WIDTH, block.y, block.z - section.z * CHUNK_DEPTH) != BlockID::Air) {
+            glm::ivec3 normal(0);
+            normal[axis] = -step[axis];
+            return RaycastResult{block, block + normal, normal, distance};
+        }
+    }
+}
+
+} // namespace
+
+namespace RaycastSystem {
+
+std::optional<RaycastResult> cast(const World& world, const glm::vec3& origin, const glm::vec3& direction, float maxDistance) {
+    ChunkCursor cursor{world};
+    return traverse(cursor, origin, direction, maxDistance);
+}
+
+void castBatch(const World& world, std::span<const Ray> rays, std::span<std::optional<RaycastResult>> results, ThreadPool* pool) {
+    if (rays.empty()) return;
+
+    // Sort rays by the chunk they start in, so a group mostly hits the cursor's cached chunk
+    auto state = std::make_shared<BatchState>();
+    state->order.resize(rays.size());
+    std::vector<uint64_t> keys(rays.size());
+    for (size_t i = 0; i < rays.size(); ++i) {
+        state->order[i] = (uint32_t)i;
+        glm::ivec3 section = sectionOf(glm::ivec3(glm::floor(rays[i].origin)));
+        keys[i] = ChunkMap::packCoord(ChunkCoord(section.x, section.z));
+    }
+    std::sort(state->order.begin(), state->order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    state->groupCount = (rays.size() + RAYS_PER_GROUP - 1) / RAYS_PER_GROUP;
+
+    // Workers and the calling thread claim groups until none are left
+    auto work = [state, &world, rays, results]() {
+        size_t finished = 0;
+        ChunkCursor cursor{world};
+        for (size_t group = state->nextGroup++; group < state->groupCount; group = state->nextGroup++) {
+            size_t end = std::min(rays.size(), (group + 1) * RAYS_PER_GROUP);
+            for (size_t i = group * RAYS_PER_GROUP; i < end; ++i) {
+                const Ray& ray = rays[state->order[i]];
+                results[state->order[i]] = traverse(cursor, ray.origin, ray.direction, ray.maxDistance);
             }
-            lastBlockPos = currentBlockPos;
+            ++finished;
+        }
+        if (finished > 0 && (state->finishedGroups += finished) == state->groupCount) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done.notify_all();
+        }
+    };
+
+    if (pool) {
+        size_t helpers = std::min<size_t>(pool->size(), state->groupCount - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            pool->submit(work);
         }
     }
+    work();
 
-    return std::nullopt; // No block was hit
+    // Helpers that never got to run find no groups left and only touch the shared state
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&]() { return state->finishedGroups == state->groupCount; });
 }
 
-} // namespace RaycastSystem
\ No newline at end of file
+} // namespace RaycastSystem
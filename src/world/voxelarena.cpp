@@ -0,0 +1,58 @@
+#include "world/voxelarena.h"
+#include <algorithm>
+#include <bit>
+
+VoxelArena::VoxelArena(size_t bytes, bool hugePages) : m_Region(bytes, hugePages) {}
+
+int VoxelArena::sizeClass(size_t bytes) {
+    size_t rounded = std::bit_ceil(std::max(bytes, (size_t)1 << MIN_CLASS_SHIFT));
+    int index = std::countr_zero(rounded) - MIN_CLASS_SHIFT;
+    return index < CLASS_COUNT ? index : -1;
+}
+
+void* VoxelArena::allocate(size_t bytes) {
+    int index = sizeClass(bytes);
+    if (index >= 0) {
+        size_t classBytes = (size_t)1 << (index + MIN_CLASS_SHIFT);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        void* block = nullptr;
+        if (m_Free[index]) {
+            block = m_Free[index];
+            m_Free[index] = m_Free[index]->next;
+        } else if (m_Used + classBytes <= m_Region.size()) {
+            // Every class is a multiple of 64 bytes, so carved blocks stay cache line aligned
+            block = static_cast<char*>(m_Region.data()) + m_Used;
+            m_Used += classBytes;
+        }
+        if (block) {
+            m_InUse += classBytes;
+            return block;
+        }
+        m_HeapBytes += bytes;
+    } else {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_HeapBytes += bytes;
+    }
+    return ::operator new(bytes);
+}
+
+void VoxelArena::deallocate(void* pointer, size_t bytes) {
+    if (!m_Region.contains(pointer)) {
+        ::operator delete(pointer);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_HeapBytes -= bytes;
+        return;
+    }
+
+    int index = sizeClass(bytes);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+    block->next = m_Free[index];
+    m_Free[index] = block;
+    m_InUse -= (size_t)1 << (index + MIN_CLASS_SHIFT);
+}
+
+VoxelArenaStats VoxelArena::getStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return {m_Region.size(), m_InUse, m_HeapBytes};
+}
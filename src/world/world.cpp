@@ -1,16 +1,194 @@
 #include "world/world.h"
 #include "world/chunksystem.h"
-#include <glm/gtc/matrix_transform.hpp>
+#include <glad/glad.h>
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <iostream>
+#include <chrono>
+#include <cmath>
 
-World::World(FastNoiseLite &noise, FastNoiseLite& detailNoise) : m_noise(noise), m_detailNoise(detailNoise) {} 
+namespace {
+
+// Calls `visit` for every coordinate within `radius` of `from` that is farther than `radius` from `to`,
+// so moving by one chunk visits a single row or column
+template <typename Visit>
+void forEachLeftBehind(const ChunkCoord& from, const ChunkCoord& to, int radius, Visit visit) {
+    for (int x = from.x - radius; x <= from.x + radius; ++x) {
+        bool columnKept = abs(x - to.x) <= radius;
+        for (int z = from.y - radius; z <= from.y + radius; ++z) {
+            if (columnKept && abs(z - to.y) <= radius) {
+                z = to.y + radius; // Skip the overlapping stretch of this column
+                continue;
+            }
+            visit(ChunkCoord(x, z));
+        }
+    }
+}
+
+// Squared distance in chunks from the player's chunk. Chunks more than 60 degrees off the view direction count as
+// twice as far away, except the ring around the player, which is needed first whichever way they look
+float loadPriority(const ChunkCoord& coord, const ChunkCoord& playerChunk, const glm::vec2& view) {
+    glm::vec2 offset(coord.x - playerChunk.x, coord.y - playerChunk.y);
+    float distanceSquared = glm::dot(offset, offset);
+    if (distanceSquared > 2.0f && glm::dot(offset, view) < 0.5f * std::sqrt(distanceSquared)) {
+        distanceSquared *= 4.0f;
+    }
+    return distanceSquared;
+}
+
+// Chunk coordinate offsets in ChunkNeighbour order
+const ChunkCoord NEIGHBOUR_OFFSETS[NEIGHBOUR_COUNT] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+} // namespace
+
+World::World(FastNoiseLite &noise, FastNoiseLite& detailNoise, unsigned int workerThreads, ChunkStorageMode storageMode,
+             bool hugePageChunks)
+    : m_ChunkPool((2 * UNLOAD_DISTANCE + 1) * (2 * UNLOAD_DISTANCE + 1) + CHUNK_POOL_HEADROOM, hugePageChunks),
+      m_Chunks(storageMode, 2 * UNLOAD_DISTANCE + 1, &m_ChunkPool), m_noise(noise), m_detailNoise(detailNoise),
+      m_Workers(workerThreads) {
+    // Report the mesh sizes of the initial load
+    m_ReportMeshStats = true;
+    m_MeshStatsStart = std::chrono::high_resolution_clock::now();
+}
 
 void World::createChunk(int x, int z) {
     ChunkCoord coord(x, z);
-    m_Chunks[coord] = Chunk(); // Create a new chunk
-    ChunkSystem::generate(m_Chunks.at(coord), x, z, m_noise, m_detailNoise);
+    Chunk& chunk = m_Chunks.emplace(coord); // Create a new chunk
+    ChunkSystem::generate(chunk, x, z, m_noise, m_detailNoise);
+    linkNeighbours(coord, chunk);
+}
+
+void World::requestChunk(const ChunkCoord& coord) {
+    if (!m_PendingChunks.insert(coord).second) {
+        return; // Already queued
+    }
+
+    // Prioritised on the next dispatch, once the stream centre has moved
+    m_LoadQueue.push_back({coord, 0.0f});
+    m_LoadQueueStale = true;
+}
+
+void World::dispatchChunkLoads(const ChunkCoord& playerChunk, const glm::vec3& viewDirection) {
+    // Keeps the lowest priority value on top of the heap
+    auto loadsLater = [](const ChunkLoad& a, const ChunkLoad& b) { return a.priority > b.priority; };
+
+    // Re-prioritise after the player moved to another chunk or turned by more than about 30 degrees
+    glm::vec2 view(viewDirection.x, viewDirection.z);
+    view = glm::dot(view, view) > 1e-6f ? glm::normalize(view) : glm::vec2(0.0f);
+    if (m_LoadQueueStale || (view != m_LoadQueueView && glm::dot(view, m_LoadQueueView) < 0.87f)) {
+        for (ChunkLoad& load : m_LoadQueue) {
+            load.priority = loadPriority(load.coord, playerChunk, view);
+        }
+        std::make_heap(m_LoadQueue.begin(), m_LoadQueue.end(), loadsLater);
+        m_LoadQueueStale = false;
+        m_LoadQueueView = view;
+    }
+
+    // A couple of jobs per worker keeps them busy without committing to an order the player may invalidate
+    const int maxJobsInFlight = 2 * (int)std::max(1u, m_Workers.size());
+    while (!m_LoadQueue.empty() && m_ChunkJobsInFlight < maxJobsInFlight) {
+        std::pop_heap(m_LoadQueue.begin(), m_LoadQueue.end(), loadsLater);
+        ChunkCoord coord = m_LoadQueue.back().coord;
+        m_LoadQueue.pop_back();
+
+        // Left behind before its turn came, or created synchronously in the meantime
+        if (abs(coord.x - playerChunk.x) > RENDER_DISTANCE || abs(coord.y - playerChunk.y) > RENDER_DISTANCE ||
+            m_Chunks.contains(coord)) {
+            m_PendingChunks.erase(coord);
+            continue;
+        }
+
+        m_ChunkJobsInFlight++;
+        m_Workers.submit([this, coord]() {
+            PooledChunk chunk = m_ChunkPool.acquire();
+            ChunkSystem::generate(*chunk, coord.x, coord.y, m_noise, m_detailNoise);
+
+            std::lock_guard<std::mutex> lock(m_GeneratedMutex);
+            m_GeneratedChunks.emplace_back(coord, std::move(chunk));
+        });
+    }
+}
+
+void World::collectGeneratedChunks(const ChunkCoord& playerChunk) {
+    {
+        std::lock_guard<std::mutex> lock(m_GeneratedMutex);
+        for (auto& generated : m_GeneratedChunks) {
+            m_ReadyChunks.push_back(std::move(generated));
+            m_ChunkJobsInFlight--;
+        }
+        m_GeneratedChunks.clear();
+    }
+
+    // Ready chunks arrive roughly in priority order, so the nearest ones are added first
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<float, std::milli> budget(m_ChunkLoadBudgetMilliseconds);
+    bool first = true;
+    while (!m_ReadyChunks.empty() && (first || std::chrono::steady_clock::now() - start < budget)) {
+        first = false;
+        auto [coord, chunk] = std::move(m_ReadyChunks.front());
+        m_ReadyChunks.pop_front();
+        m_PendingChunks.erase(coord);
+
+        // The player may have moved away, or the chunk was created synchronously in the meantime
+        int dx = abs(coord.x - playerChunk.x);
+        int dz = abs(coord.y - playerChunk.y);
+        if (dx > UNLOAD_DISTANCE || dz > UNLOAD_DISTANCE || m_Chunks.contains(coord)) {
+            continue;
+        }
+
+        linkNeighbours(coord, m_Chunks.insert(coord, std::move(chunk)));
+    }
+}
+
+void World::linkNeighbours(const ChunkCoord& coord, Chunk& chunk) {
+    chunk.dirtySections = 0;
+    markDirty(coord, chunk, ALL_SECTIONS);
+
+    for (int side = 0; side < NEIGHBOUR_COUNT; ++side) {
+        ChunkCoord neighbourCoord = coord + NEIGHBOUR_OFFSETS[side];
+        Chunk* neighbour = m_Chunks.find(neighbourCoord);
+        chunk.neighbours[side] = neighbour;
+        if (!neighbour) {
+            continue;
+        }
+        neighbour->neighbours[side ^ 1] = &chunk;
+
+        // Remesh the neighbour's sections where the new chunk hides a different set of border faces than their meshes
+        // assumed, which is never the case for an all-air border or a chunk reloaded unchanged
+        uint16_t changed = 0;
+        for (int section = 0; section < SECTION_COUNT; ++section) {
+            if (ChunkSystem::borderContactsChanged(*neighbour, side ^ 1, section, &chunk)) {
+                changed |= 1u << section;
+            }
+        }
+        markDirty(neighbourCoord, *neighbour, changed);
+    }
+}
+
+void World::unloadChunk(const ChunkCoord& coord) {
+    Chunk* chunk = m_Chunks.find(coord);
+    if (!chunk) {
+        return;
+    }
+
+    for (int side = 0; side < NEIGHBOUR_COUNT; ++side) {
+        if (Chunk* neighbour = chunk->neighbours[side]) {
+            neighbour->neighbours[side ^ 1] = nullptr;
+        }
+    }
+    ChunkSystem::unloadMesh(m_MeshArena, *chunk);
+    m_Chunks.erase(coord);
+}
+
+void World::markDirty(const ChunkCoord& coord, Chunk& chunk, uint16_t sections) {
+    if (sections == 0) {
+        return;
+    }
+    if (chunk.dirtySections == 0) {
+        m_DirtyChunks.push_back(coord);
+    }
+    chunk.dirtySections |= sections;
 }
 
 BlockID World::getBlock(int worldX, int worldY, int worldZ) const {
@@ -22,63 +200,84 @@ BlockID World::getBlock(int worldX, int worldY, int worldZ) const {
     ChunkCoord chunkCoord(floor((float)worldX / CHUNK_WIDTH), floor((float)worldZ / CHUNK_DEPTH));
 
     // Not a loaded chunk, should not happen
-    if (!m_Chunks.contains(chunkCoord)) {
+    const Chunk* chunk = m_Chunks.find(chunkCoord);
+    if (!chunk) {
         return BlockID::Air;
     }
 
     int localX = worldX - chunkCoord.x * CHUNK_WIDTH;
     int localZ = worldZ - chunkCoord.y * CHUNK_DEPTH;
 
-    return m_Chunks.at(chunkCoord).blocks[localX][worldY][localZ];
+    return chunk->getBlock(localX, worldY, localZ);
 }
 
-void World::updateChunksAroundPlayer(const glm::vec3 &position) {
-    int currentChunkX = static_cast<int>(floor(position.x / CHUNK_WIDTH));
-    int currentChunkZ = static_cast<int>(floor(position.z / CHUNK_DEPTH));
-    std::vector<ChunkCoord> toUnload;
+const Chunk* World::getChunk(const ChunkCoord& coord) const {
+    return m_Chunks.find(coord);
+}
 
+bool World::isSectionEmpty(int worldX, int worldY, int worldZ) const {
+    if (worldY < 0 || worldY >= CHUNK_HEIGHT) {
+        return true;
+    }
 
-    for (auto& [coord, chunk] : m_Chunks) {
-        int dx = abs(coord.x - currentChunkX);
-        int dz = abs(coord.y - currentChunkZ);
+    ChunkCoord chunkCoord(floor((float)worldX / CHUNK_WIDTH), floor((float)worldZ / CHUNK_DEPTH));
+    const Chunk* chunk = m_Chunks.find(chunkCoord);
+    return !chunk || chunk->isSectionEmpty(worldY / SECTION_HEIGHT);
+}
 
-        if (dx > UNLOAD_DISTANCE || dz > UNLOAD_DISTANCE) {
-            toUnload.push_back(coord);
-        }
+void World::updateChunksAroundPlayer(const glm::vec3 &position, const glm::vec3& viewDirection) {
+    ChunkCoord playerChunk(static_cast<int>(floor(position.x / CHUNK_WIDTH)), static_cast<int>(floor(position.z / CHUNK_DEPTH)));
+
+    if (!m_HasStreamCentre || playerChunk != m_StreamCentre) {
+        moveStreamCentre(playerChunk);
     }
 
-    for (const auto& coord : toUnload) {
-        ChunkSystem::unloadMesh(m_Chunks.at(coord));
-        m_Chunks.erase(coord);
+    collectGeneratedChunks(playerChunk);
+    dispatchChunkLoads(playerChunk, viewDirection);
+}
+
+void World::moveStreamCentre(const ChunkCoord& playerChunk) {
+    if (!m_HasStreamCentre) {
+        // First call: chunks created before streaming started may lie anywhere
+        std::vector<ChunkCoord> toUnload;
+        for (auto&& [coord, chunk] : m_Chunks) {
+            if (abs(coord.x - playerChunk.x) > UNLOAD_DISTANCE || abs(coord.y - playerChunk.y) > UNLOAD_DISTANCE) {
+                toUnload.push_back(coord);
+            }
+        }
+        for (const ChunkCoord& coord : toUnload) {
+            unloadChunk(coord);
+        }
+    } else {
+        // Only the rows and columns the player moved away from can fall out of range
+        forEachLeftBehind(m_StreamCentre, playerChunk, UNLOAD_DISTANCE, [&](const ChunkCoord& coord) {
+            unloadChunk(coord);
+        });
     }
 
-    for (int x = currentChunkX - RENDER_DISTANCE; x <= currentChunkX + RENDER_DISTANCE; x++) {
-        for (int z = currentChunkZ - RENDER_DISTANCE; z <= currentChunkZ + RENDER_DISTANCE; z++) {
-            ChunkCoord coord(x, z);
-            
-            if (m_Chunks.find(coord) == m_Chunks.end()) {
-                createChunk(x, z);
-                
-                ChunkCoord neighbor_posX(x + 1, z);
-                ChunkCoord neighbor_negX(x - 1, z);
-                ChunkCoord neighbor_posZ(x, z + 1);
-                ChunkCoord neighbor_negZ(x, z - 1);
+    // The chunk the player stands in is needed for collision right away
+    if (!m_Chunks.contains(playerChunk)) {
+        createChunk(playerChunk.x, playerChunk.y);
+    }
 
-                if (m_Chunks.count(neighbor_posX)) {
-                    m_Chunks.at(neighbor_posX).isDirty = true;
-                }
-                if (m_Chunks.count(neighbor_negX)) {
-                    m_Chunks.at(neighbor_negX).isDirty = true;
-                }
-                if (m_Chunks.count(neighbor_posZ)) {
-                    m_Chunks.at(neighbor_posZ).isDirty = true;
-                }
-                if (m_Chunks.count(neighbor_negZ)) {
-                    m_Chunks.at(neighbor_negZ).isDirty = true;
-                }
+    // Request the newly entered rows and columns, or the whole square on the first call
+    auto requestMissing = [&](const ChunkCoord& coord) {
+        if (!m_Chunks.contains(coord)) {
+            requestChunk(coord);
+        }
+    };
+    if (!m_HasStreamCentre) {
+        for (int x = playerChunk.x - RENDER_DISTANCE; x <= playerChunk.x + RENDER_DISTANCE; x++) {
+            for (int z = playerChunk.y - RENDER_DISTANCE; z <= playerChunk.y + RENDER_DISTANCE; z++) {
+                requestMissing(ChunkCoord(x, z));
             }
         }
+    } else {
+        forEachLeftBehind(playerChunk, m_StreamCentre, RENDER_DISTANCE, requestMissing);
     }
+
+    m_StreamCentre = playerChunk;
+    m_HasStreamCentre = true;
 }
 
 
@@ -89,66 +288,276 @@ void World::setBlock(int worldX, int worldY, int worldZ, BlockID type) {
     std::cout << "Setting block on: " << worldX << ":" << worldY << ":" << worldZ << std::endl;
     ChunkCoord chunkCoord(floor((float)worldX / CHUNK_WIDTH), floor((float)worldZ / CHUNK_DEPTH));
 
-    if (!m_Chunks.contains(chunkCoord)) {
+    Chunk* chunk = m_Chunks.find(chunkCoord);
+    if (!chunk) {
         return;
     }
 
     int localX = worldX - chunkCoord.x * CHUNK_WIDTH;
     int localZ = worldZ - chunkCoord.y * CHUNK_DEPTH;
 
-    m_Chunks.at(chunkCoord).blocks[localX][worldY][localZ] = type;
-    m_Chunks.at(chunkCoord).isDirty = true;
+    bool wasSolid = chunk->getBlock(localX, worldY, localZ) != BlockID::Air;
+    bool isSolid = type != BlockID::Air;
+    chunk->setBlock(localX, worldY, localZ, type);
 
-    //Check for borders and mark neighbors as dirty
+    // The block's section, and the section it borders when it lies on the top or bottom layer
+    int section = worldY / SECTION_HEIGHT;
+    uint16_t sections = 1u << section;
+    if (worldY % SECTION_HEIGHT == 0 && section > 0) {
+        sections |= 1u << (section - 1);
+    } else if (worldY % SECTION_HEIGHT == SECTION_HEIGHT - 1 && section < SECTION_COUNT - 1) {
+        sections |= 1u << (section + 1);
+    }
+    markDirty(chunkCoord, *chunk, sections);
+
+    // Breaking the last block of a section turns it back into a single value
+    if (type == BlockID::Air) {
+        chunk->sections[worldY / SECTION_HEIGHT].compact();
+        if (worldY == chunk->minHeight || worldY == chunk->maxHeight - 1) {
+            ChunkSystem::updateHeightBounds(*chunk);
+        }
+    } else if (chunk->maxHeight == 0) {
+        chunk->minHeight = worldY;
+        chunk->maxHeight = worldY + 1;
+    } else {
+        chunk->minHeight = std::min(chunk->minHeight, worldY);
+        chunk->maxHeight = std::max(chunk->maxHeight, worldY + 1);
+    }
+
+    // A border block changing solidity updates the border mask, and exposes or hides the face of the neighbour's
+    // block next to it; when that block is air the neighbour's mesh does not change
+    if (wasSolid == isSolid) {
+        return;
+    }
+    auto updateSide = [&](int side, int along) {
+        uint16_t bit = (uint16_t)(1u << along);
+        chunk->borderMasks[side][worldY] ^= bit;
+
+        Chunk* neighbour = chunk->neighbours[side];
+        if (neighbour && (neighbour->borderMasks[side ^ 1][worldY] & bit)) {
+            markDirty(chunkCoord + NEIGHBOUR_OFFSETS[side], *neighbour, 1u << section);
+        }
+    };
     if (localX == 0) {
-        ChunkCoord neighborCoord = {chunkCoord.x - 1, chunkCoord.y};
-        if (m_Chunks.contains(neighborCoord)) m_Chunks.at(neighborCoord).isDirty = true;
+        updateSide(NEIGHBOUR_NEG_X, localZ);
     } else if (localX == CHUNK_WIDTH - 1) {
-        ChunkCoord neighborCoord = {chunkCoord.x + 1, chunkCoord.y};
-        if (m_Chunks.contains(neighborCoord)) m_Chunks.at(neighborCoord).isDirty = true;
+        updateSide(NEIGHBOUR_POS_X, localZ);
     }
 
     if (localZ == 0) {
-        ChunkCoord neighborCoord = {chunkCoord.x, chunkCoord.y - 1};
-        if (m_Chunks.contains(neighborCoord)) m_Chunks.at(neighborCoord).isDirty = true;
+        updateSide(NEIGHBOUR_NEG_Z, localX);
     } else if (localZ == CHUNK_DEPTH - 1) {
-        ChunkCoord neighborCoord = {chunkCoord.x, chunkCoord.y + 1};
-        if (m_Chunks.contains(neighborCoord)) m_Chunks.at(neighborCoord).isDirty = true;
+        updateSide(NEIGHBOUR_POS_Z, localX);
     }
 }
 
 void World::update() {
-    // Find all dirty chunks and rebuild their mesh.
-    for (auto& [coord, chunk] : m_Chunks) {
-        if (chunk.isDirty) {
-            // Find neighbors for the current chunk
-            ChunkCoord K_posX = ChunkCoord(coord.x + 1, coord.y);
-            ChunkCoord K_negX = ChunkCoord(coord.x - 1, coord.y);
-            ChunkCoord K_posZ = ChunkCoord(coord.x, coord.y + 1);
-            ChunkCoord K_negZ = ChunkCoord(coord.x, coord.y - 1);
-
-            // Get pointers to neighbors, or nullptr if they don't exist
-            Chunk* p_posX = m_Chunks.count(K_posX) ? &m_Chunks.at(K_posX) : nullptr;
-            Chunk* p_negX = m_Chunks.count(K_negX) ? &m_Chunks.at(K_negX) : nullptr;
-            Chunk* p_posZ = m_Chunks.count(K_posZ) ? &m_Chunks.at(K_posZ) : nullptr;
-            Chunk* p_negZ = m_Chunks.count(K_negZ) ? &m_Chunks.at(K_negZ) : nullptr;
-            
-            // Call buildMesh with the chunk and its neighbors
-            ChunkSystem::buildMesh(chunk, p_posX, p_negX, p_posZ, p_negZ);
-        }
-    }
-}
-
-void World::render(Shader& shader) const {
-    // Draw all chunks that have a mesh.
-    for (auto const& [coord, chunk] : m_Chunks) {
-        if (chunk.vertexCount > 0) {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(coord.x * CHUNK_WIDTH, 0, coord.y * CHUNK_DEPTH));
-            shader.setMat4("model", model);
-            
-            glBindVertexArray(chunk.VAO);
-            glDrawArrays(GL_TRIANGLES, 0, chunk.vertexCount);
-        }
-    }
-}
\ No newline at end of file
+    scheduleMeshJobs();
+    uploadBuiltMeshes();
+
+    // Waits for the first chunks when nothing is loaded yet, the averages below are per chunk
+    if (m_ReportMeshStats && m_MeshJobsInFlight == 0 && m_PendingChunks.empty() && m_Chunks.size() > 0) {
+        auto end = std::chrono::high_resolution_clock::now();
+        double milliseconds = std::chrono::duration<double, std::milli>(end - m_MeshStatsStart).count();
+        double buildMilliseconds = m_MeshBuildMicroseconds.exchange(0) / 1000.0;
+
+        long long totalVertices = 0;
+        long long voxelBytes = 0;
+        for (auto const& [coord, chunk] : m_Chunks) {
+            for (const SectionMesh& mesh : chunk.meshes) {
+                totalVertices += mesh.vertexCount;
+            }
+            for (const BlockStorage& section : chunk.sections) {
+                voxelBytes += section.memoryUsage();
+            }
+        }
+        long long denseVoxelBytes = (long long)m_Chunks.size() * CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH * sizeof(BlockID);
+        long long bytesPerChunk = totalVertices * (long long)sizeof(ChunkVertex) / (long long)m_Chunks.size();
+        long long unpackedBytesPerChunk = totalVertices * UNPACKED_VERTEX_BYTES / (long long)m_Chunks.size();
+        MeshArenaStats arena = m_MeshArena.getStats();
+        ChunkPoolStats pool = m_ChunkPool.getStats();
+
+        std::cout << (m_MeshingMode == MeshingMode::Greedy ? "Greedy" : "Naive") << " mesher: rebuilt "
+                  << m_Chunks.size() << " chunks in " << milliseconds << " ms ("
+                  << buildMilliseconds << " ms of worker time), "
+                  << totalVertices << " vertices loaded, "
+                  << bytesPerChunk << " bytes per chunk mesh (" << unpackedBytesPerChunk << " unpacked), "
+                  << voxelBytes / 1024 << " KiB of voxels (" << denseVoxelBytes / 1024 << " KiB dense), "
+                  << "mesh arena " << arena.allocatedBytes / 1024 << "/" << arena.capacityBytes / 1024 << " KiB in use, "
+                  << arena.freeRanges << " free ranges, " << (int)(arena.fragmentation() * 100) << "% fragmented, "
+                  << "chunk pool " << pool.inUse << "/" << pool.capacity << " in use, " << pool.heapChunks << " from heap, "
+                  << "voxel arena " << pool.voxels.inUse / 1024 << "/" << pool.voxels.capacity / 1024 << " KiB in use, "
+                  << pool.voxels.heapBytes / 1024 << " KiB from heap" << (pool.hugePages ? " (huge pages)" : "") << std::endl;
+        m_ReportMeshStats = false;
+    }
+}
+
+void World::scheduleMeshJobs() {
+    // Snapshots are shared between the jobs of this frame, so each chunk is copied at most once
+    std::map<const Chunk*, std::shared_ptr<const Chunk>> snapshots;
+    auto snapshot = [&](const Chunk* chunk) -> std::shared_ptr<const Chunk> {
+        if (!chunk) {
+            return nullptr;
+        }
+
+        std::shared_ptr<const Chunk>& copy = snapshots[chunk];
+        if (!copy) {
+            copy = std::make_shared<const Chunk>(*chunk);
+        }
+        return copy;
+    };
+
+    size_t waiting = 0;
+    for (const ChunkCoord& coord : m_DirtyChunks) {
+        Chunk* found = m_Chunks.find(coord);
+        if (!found || found->dirtySections == 0) {
+            continue; // Unloaded, or a stale entry left by an earlier chunk at the same coordinate
+        }
+
+        // A chunk edited while its job is in flight is picked up again once that job lands
+        Chunk& chunk = *found;
+        if (chunk.meshPending) {
+            m_DirtyChunks[waiting++] = coord;
+            continue;
+        }
+
+        uint16_t sections = chunk.dirtySections;
+        chunk.dirtySections = 0;
+        chunk.meshPending = true;
+        chunk.meshTicket = ++m_NextMeshTicket;
+        m_MeshJobsInFlight++;
+        for (int section = 0; section < SECTION_COUNT; ++section) {
+            if (sections & (1u << section)) ChunkSystem::recordBorderContacts(chunk, section);
+        }
+
+        std::shared_ptr<const Chunk> center = snapshot(&chunk);
+        std::shared_ptr<const Chunk> posX = snapshot(chunk.neighbours[NEIGHBOUR_POS_X]);
+        std::shared_ptr<const Chunk> negX = snapshot(chunk.neighbours[NEIGHBOUR_NEG_X]);
+        std::shared_ptr<const Chunk> posZ = snapshot(chunk.neighbours[NEIGHBOUR_POS_Z]);
+        std::shared_ptr<const Chunk> negZ = snapshot(chunk.neighbours[NEIGHBOUR_NEG_Z]);
+
+        m_Workers.submit([this, coord, ticket = chunk.meshTicket, sections, mode = m_MeshingMode, center, posX, negX, posZ, negZ]() {
+            auto start = std::chrono::high_resolution_clock::now();
+            BuiltMesh mesh{coord, ticket, sections,
+                           ChunkSystem::buildSectionMeshData(*center, posX.get(), negX.get(), posZ.get(), negZ.get(), sections, mode)};
+            auto end = std::chrono::high_resolution_clock::now();
+            m_MeshBuildMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+            std::lock_guard<std::mutex> lock(m_BuiltMutex);
+            m_BuiltMeshes.push_back(std::move(mesh));
+        });
+    }
+    m_DirtyChunks.resize(waiting);
+}
+
+void World::uploadBuiltMeshes() {
+    {
+        std::lock_guard<std::mutex> lock(m_BuiltMutex);
+        for (BuiltMesh& mesh : m_BuiltMeshes) {
+            m_ReadyMeshes.push_back(std::move(mesh));
+        }
+        m_BuiltMeshes.clear();
+    }
+
+    // The previous mesh stays drawable until its replacement gets a slot in the budget
+    size_t uploadedBytes = 0;
+    int uploadedChunks = 0;
+    while (!m_ReadyMeshes.empty() && uploadedChunks < m_MaxUploadChunksPerFrame && uploadedBytes < m_MaxUploadBytesPerFrame) {
+        BuiltMesh mesh = std::move(m_ReadyMeshes.front());
+        m_ReadyMeshes.pop_front();
+        m_MeshJobsInFlight--;
+
+        // Drop meshes of chunks that were unloaded, or unloaded and loaded again, since the job started
+        Chunk* chunk = m_Chunks.find(mesh.coord);
+        if (!chunk || chunk->meshTicket != mesh.ticket) {
+            continue;
+        }
+
+        for (int section = 0; section < SECTION_COUNT; ++section) {
+            if (mesh.sections & (1u << section)) {
+                ChunkSystem::uploadMesh(m_MeshArena, *chunk, section, mesh.coord.x, mesh.coord.y, mesh.vertices[section]);
+                uploadedBytes += mesh.vertices[section].size() * sizeof(ChunkVertex);
+            }
+        }
+        chunk->meshPending = false;
+        uploadedChunks++;
+    }
+}
+
+void World::setMeshUploadBudget(size_t maxBytesPerFrame, int maxChunksPerFrame) {
+    m_MaxUploadBytesPerFrame = maxBytesPerFrame;
+    m_MaxUploadChunksPerFrame = maxChunksPerFrame;
+}
+
+void World::setChunkLoadBudget(float milliseconds) {
+    m_ChunkLoadBudgetMilliseconds = milliseconds;
+}
+
+void World::setMeshingMode(MeshingMode mode) {
+    m_MeshingMode = mode;
+    m_ReportMeshStats = true;
+    m_MeshStatsStart = std::chrono::high_resolution_clock::now();
+    m_MeshBuildMicroseconds = 0;
+
+    for (auto&& [coord, chunk] : m_Chunks) {
+        markDirty(coord, chunk, ALL_SECTIONS);
+    }
+}
+
+MeshingMode World::getMeshingMode() const {
+    return m_MeshingMode;
+}
+
+void World::render(const glm::mat4& viewProjection) {
+    // Gather the bounds of every chunk with a mesh, then test them all against the frustum in one pass
+    m_DrawChunks.clear();
+    m_DrawBounds.clear();
+    for (auto&& [coord, chunk] : m_Chunks) {
+        bool hasMesh = std::any_of(chunk.meshes.begin(), chunk.meshes.end(), [](const SectionMesh& mesh) { return mesh.indexCount > 0; });
+        if (hasMesh) {
+            glm::vec3 origin(coord.x * CHUNK_WIDTH, 0, coord.y * CHUNK_DEPTH);
+            m_DrawBounds.push(origin + glm::vec3(0, chunk.minHeight, 0), origin + glm::vec3(CHUNK_WIDTH, chunk.maxHeight, CHUNK_DEPTH));
+            m_DrawChunks.push_back(&chunk);
+        }
+    }
+    Frustum(viewProjection).cull(m_DrawBounds, m_DrawVisible);
+
+    // The sections of visible chunks become one multi-draw; the shader finds each mesh's origin from its vertex index
+    m_DrawCounts.clear();
+    m_DrawIndexOffsets.clear();
+    m_DrawBaseVertices.clear();
+    m_RenderStats = {};
+    for (size_t i = 0; i < m_DrawChunks.size(); ++i) {
+        if (!m_DrawVisible[i]) continue;
+
+        m_RenderStats.chunksDrawn++;
+        for (const SectionMesh& mesh : m_DrawChunks[i]->meshes) {
+            if (mesh.indexCount > 0) {
+                m_DrawCounts.push_back(mesh.indexCount);
+                m_DrawIndexOffsets.push_back(nullptr);
+                m_DrawBaseVertices.push_back((int)mesh.allocation.firstVertex);
+            }
+        }
+    }
+    m_RenderStats.chunksCulled = (int)m_DrawChunks.size() - m_RenderStats.chunksDrawn;
+    if (m_DrawCounts.empty()) {
+        return;
+    }
+
+    m_MeshArena.bind(CHUNK_ORIGIN_TEXTURE_UNIT);
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_DrawCounts.data(), GL_UNSIGNED_INT, m_DrawIndexOffsets.data(),
+                                  (GLsizei)m_DrawCounts.size(), m_DrawBaseVertices.data());
+    m_RenderStats.drawCalls = 1;
+}
+
+const World::RenderStats& World::getRenderStats() const {
+    return m_RenderStats;
+}
+
+MeshArenaStats World::getMeshArenaStats() const {
+    return m_MeshArena.getStats();
+}
+
+ChunkPoolStats World::getChunkPoolStats() const {
+    return m_ChunkPool.getStats();
+}